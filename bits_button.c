@@ -1,9 +1,56 @@
+#if (defined(BITS_BTN_ENABLE_WAIT) || defined(BITS_BTN_ENABLE_EVENTFD) || defined(BITS_BTN_ENABLE_TICK_THREAD)) \
+    && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include "bits_button.h"
 #include <string.h>
+#ifdef BITS_BTN_ENABLE_WAIT
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
 
+#if defined(BITS_BTN_ENABLE_SOA_ENGINE) && !defined(BITS_BTN_SOA_NO_SIMD) \
+    && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BITS_BTN_SOA_X86
+#include <immintrin.h>
+#endif
+
+// Default instance used by the non-ctx API
 static bits_button_t bits_btn_entity;
-static bits_btn_debug_printf_func debug_printf = NULL;
-static void debug_print_binary(key_value_type_t num);
+// init_magic of an initialized instance, so init can tell it from new storage
+#define BITS_BTN_INSTANCE_MAGIC     0x4254494EU
+static void debug_print_binary(bits_button_t *button, key_value_type_t num);
+static void debug_print_mask(bits_button_t *button, const bits_btn_mask_t *mask);
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+static void bitslice_load(bits_button_t *button);
+#endif
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+static uint8_t soa_select_kernel(void);
+static void soa_load(bits_button_t *button);
+#endif
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+static void wheel_load(bits_button_t *button);
+#endif
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+static void tick_thread_destroy_lock(bits_button_t *button);
+#endif
 
 // Internal state machine states (not exposed to users)
 typedef enum {
@@ -26,6 +73,200 @@ static bits_btn_event_t state_to_event(bits_btn_state_t state)
     }
 }
 
+// ============================================================================
+// Button Mask Operations
+// ============================================================================
+// All mask arithmetic goes through these helpers so the engine works the same
+// with a single-word mask and with the multi-word bits_btn_mask_t. The
+// multi-word versions use fixed-trip-count loops without early exits so the
+// compiler can turn them into vector AND/OR/compare instructions.
+
+#if BITS_BTN_MASK_WORDS > 1
+
+static inline void btn_mask_clear(bits_btn_mask_t *mask)
+{
+    memset(mask, 0, sizeof(*mask));
+}
+
+static inline void btn_mask_set_bit(bits_btn_mask_t *mask, size_t bit)
+{
+    mask->w[bit / BITS_BTN_MASK_WORD_BITS] |= ((button_mask_type_t)1UL << (bit % BITS_BTN_MASK_WORD_BITS));
+}
+
+static inline uint8_t btn_mask_test_bit(const bits_btn_mask_t *mask, size_t bit)
+{
+    return (mask->w[bit / BITS_BTN_MASK_WORD_BITS] >> (bit % BITS_BTN_MASK_WORD_BITS)) & 1U;
+}
+
+static inline void btn_mask_flip_bit(bits_btn_mask_t *mask, size_t bit)
+{
+    mask->w[bit / BITS_BTN_MASK_WORD_BITS] ^= ((button_mask_type_t)1UL << (bit % BITS_BTN_MASK_WORD_BITS));
+}
+
+static inline void btn_mask_clear_bit(bits_btn_mask_t *mask, size_t bit)
+{
+    mask->w[bit / BITS_BTN_MASK_WORD_BITS] &= ~((button_mask_type_t)1UL << (bit % BITS_BTN_MASK_WORD_BITS));
+}
+
+static inline button_mask_type_t btn_mask_word(const bits_btn_mask_t *mask, size_t word)
+{
+    return mask->w[word];
+}
+
+static inline button_mask_type_t *btn_mask_words(bits_btn_mask_t *mask)
+{
+    return mask->w;
+}
+
+static inline bits_btn_mask_t btn_mask_and(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        a.w[i] &= b.w[i];
+    return a;
+}
+
+static inline bits_btn_mask_t btn_mask_or(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        a.w[i] |= b.w[i];
+    return a;
+}
+
+static inline bits_btn_mask_t btn_mask_xor(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        a.w[i] ^= b.w[i];
+    return a;
+}
+
+static inline bits_btn_mask_t btn_mask_andnot(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        a.w[i] &= ~b.w[i];
+    return a;
+}
+
+static inline uint8_t btn_mask_equal(const bits_btn_mask_t *a, const bits_btn_mask_t *b)
+{
+    button_mask_type_t diff = 0;
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        diff |= a->w[i] ^ b->w[i];
+    return diff == 0;
+}
+
+static inline uint8_t btn_mask_intersects(const bits_btn_mask_t *a, const bits_btn_mask_t *b)
+{
+    button_mask_type_t common = 0;
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        common |= a->w[i] & b->w[i];
+    return common != 0;
+}
+
+/* Check whether every bit of sub is also set in mask */
+static inline uint8_t btn_mask_contains(const bits_btn_mask_t *mask, const bits_btn_mask_t *sub)
+{
+    button_mask_type_t missing = 0;
+    for (size_t i = 0; i < BITS_BTN_MASK_WORDS; i++)
+        missing |= sub->w[i] & ~mask->w[i];
+    return missing == 0;
+}
+
+#else
+
+static inline void btn_mask_clear(bits_btn_mask_t *mask)
+{
+    *mask = 0;
+}
+
+static inline void btn_mask_set_bit(bits_btn_mask_t *mask, size_t bit)
+{
+    *mask |= ((button_mask_type_t)1UL << bit);
+}
+
+static inline uint8_t btn_mask_test_bit(const bits_btn_mask_t *mask, size_t bit)
+{
+    return (*mask >> bit) & 1U;
+}
+
+static inline void btn_mask_flip_bit(bits_btn_mask_t *mask, size_t bit)
+{
+    *mask ^= ((button_mask_type_t)1UL << bit);
+}
+
+static inline void btn_mask_clear_bit(bits_btn_mask_t *mask, size_t bit)
+{
+    *mask &= ~((button_mask_type_t)1UL << bit);
+}
+
+static inline button_mask_type_t btn_mask_word(const bits_btn_mask_t *mask, size_t word)
+{
+    (void)word;
+    return *mask;
+}
+
+static inline button_mask_type_t *btn_mask_words(bits_btn_mask_t *mask)
+{
+    return mask;
+}
+
+static inline bits_btn_mask_t btn_mask_and(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    return a & b;
+}
+
+static inline bits_btn_mask_t btn_mask_or(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    return a | b;
+}
+
+static inline bits_btn_mask_t btn_mask_xor(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    return a ^ b;
+}
+
+static inline bits_btn_mask_t btn_mask_andnot(bits_btn_mask_t a, bits_btn_mask_t b)
+{
+    return a & ~b;
+}
+
+static inline uint8_t btn_mask_equal(const bits_btn_mask_t *a, const bits_btn_mask_t *b)
+{
+    return *a == *b;
+}
+
+static inline uint8_t btn_mask_intersects(const bits_btn_mask_t *a, const bits_btn_mask_t *b)
+{
+    return (*a & *b) != 0;
+}
+
+/* Check whether every bit of sub is also set in mask */
+static inline uint8_t btn_mask_contains(const bits_btn_mask_t *mask, const bits_btn_mask_t *sub)
+{
+    return (*mask & *sub) == *sub;
+}
+
+#endif
+
+/**
+  * @brief  Count trailing zeros of a non-zero mask word.
+  * @param  word: Mask word, must not be zero.
+  * @retval Index of the lowest set bit.
+  */
+static inline uint32_t btn_mask_word_ctz(button_mask_type_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzl((unsigned long)word);
+#else
+    static const uint8_t debruijn_position[32] =
+    {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    uint32_t lowest_bit = (uint32_t)word & (uint32_t)(0UL - (uint32_t)word);
+    return debruijn_position[(uint32_t)(lowest_bit * 0x077CB531UL) >> 27];
+#endif
+}
+
 // ============================================================================
 // Buffer Implementation Selection
 // ============================================================================
@@ -49,914 +290,4304 @@ void bits_button_set_buffer_ops(const bits_btn_buffer_ops_t *user_buffer_ops)
 }
 
 #else
-// Default C11 atomic buffer implementation
-#include <stdatomic.h>
-
-#ifndef BITS_BTN_BUFFER_SIZE
-#define BITS_BTN_BUFFER_SIZE        10
-#endif
-
-typedef struct
-{
-    bits_btn_result_t buffer[BITS_BTN_BUFFER_SIZE];
-    atomic_size_t read_idx;   // Atomic read index
-    atomic_size_t write_idx;  // Atomic write index
-} bits_btn_ring_buffer_t;
-
-static atomic_size_t overwrite_count = 0;
-static bits_btn_ring_buffer_t ring_buffer;
-
+// Default C11 atomic buffer implementation, one ring per bits_button_t instance
 
 /**
   * @brief  Initialize the ring buffer for button results.
+  * @param  buf: Ring buffer to initialize.
+  * @param  storage: Caller-provided slots, or NULL to use the built-in BITS_BTN_BUFFER_SIZE slots
+  *         (required with BITS_BTN_NO_BUILTIN_BUFFER).
+  * @param  size: Number of slots in storage.
+  * @param  overflow_policy: bits_btn_overflow_policy_t applied when the ring is full.
   * @retval None
   */
-static void bits_btn_init_buffer_c11(void)
+static void bits_btn_init_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *storage, size_t size, uint8_t overflow_policy)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
+#ifdef BITS_BTN_NO_BUILTIN_BUFFER
+    buf->slots = storage;
+    buf->size = size;
+#else
+    buf->slots = (storage != NULL) ? storage : buf->buffer;
+    buf->size = (storage != NULL) ? size : BITS_BTN_BUFFER_SIZE;
+#endif
+    buf->overflow_policy = overflow_policy;
+    buf->held_valid = 0;
+#ifdef BITS_BTN_ENABLE_STATS
+    buf->held_published = 0;
+#endif
     atomic_init(&buf->read_idx, 0);
     atomic_init(&buf->write_idx, 0);
-    atomic_init(&overwrite_count, 0);
+    atomic_init(&buf->overwrite_count, 0);
 }
 
-static uint8_t bits_btn_is_buffer_empty_c11(void)
+/**
+  * @brief  Check whether a result is a long press repeat, which a newer result may replace.
+  *         The long press start (trigger count 0) is kept like any other result.
+  * @param  result: Button result.
+  * @retval true for a repeat.
+  */
+static inline uint8_t bits_btn_is_hold_repeat(const bits_btn_result_t *result)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
+    return result->event == BTN_EVENT_LONG_PRESS && result->long_press_period_trigger_cnt != 0;
+}
 
+#ifdef BITS_BTN_USE_POW2_BUFFER
+// Power-of-two ring: read_idx and write_idx run freely and are masked into the
+// slots, so write - read is the fill level and no slot is reserved. On overflow
+// the producer drops the oldest result by moving read_idx with a compare-and-swap;
+// the consumer claims results with a compare-and-swap as well and retries when
+// the producer dropped them under it.
+
+static uint8_t bits_btn_is_buffer_empty_c11(bits_btn_ring_buffer_t *buf)
+{
     size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
     size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
     return current_read == current_write;
 }
 
-static uint8_t bits_btn_is_buffer_full_c11(void)
+static size_t get_bits_btn_buffer_used_count_c11(bits_btn_ring_buffer_t *buf)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
-    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    // read_idx first: it only grows, so the difference cannot underflow
     size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
-    size_t next_write = (current_write + 1) % BITS_BTN_BUFFER_SIZE;
-    return next_write == current_read;
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t used = current_write - current_read;
+
+    return (used > buf->size) ? buf->size : used;
 }
 
-static size_t get_bits_btn_buffer_used_count_c11(void)
+static uint8_t bits_btn_is_buffer_full_c11(bits_btn_ring_buffer_t *buf)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
-    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
-
-    if (current_write >= current_read)
-    {
-        return current_write - current_read;
-    }
-    else
-    {
-        return BITS_BTN_BUFFER_SIZE - current_read + current_write;
-    }
+    return get_bits_btn_buffer_used_count_c11(buf) == buf->size;
 }
 
-static size_t get_bits_btn_buffer_capacity_c11(void)
+static size_t get_bits_btn_buffer_capacity_c11(bits_btn_ring_buffer_t *buf)
 {
-    // A circular buffer needs to reserve 1 empty slot to distinguish between full and empty states,
-    // so the actual available capacity is SIZE - 1.
-    return BITS_BTN_BUFFER_SIZE - 1;
+    return buf->size;
 }
 
 /**
   * @brief  Clear the ring buffer. Note that additional synchronization is required in a multi-threaded environment.
+  * @param  buf: Ring buffer to clear.
   * @retval None
   */
-static void bits_btn_clear_buffer_c11(void)
+static void bits_btn_clear_buffer_c11(bits_btn_ring_buffer_t *buf)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
+    buf->held_valid = 0;
     atomic_store_explicit(&buf->write_idx, 0, memory_order_release);
     atomic_store_explicit(&buf->read_idx, 0, memory_order_release);
 }
 
-static size_t get_bits_btn_buffer_overwrite_count_c11(void)
+static size_t get_bits_btn_buffer_overwrite_count_c11(bits_btn_ring_buffer_t *buf)
 {
-    return atomic_load_explicit(&overwrite_count, memory_order_relaxed);
+    return atomic_load_explicit(&buf->overwrite_count, memory_order_relaxed);
 }
-#if 0
+
 /**
-  * @brief  Write a button result to the ring buffer.
+  * @brief  Write a button result to the ring buffer unless it is full.
+  * @param  buf: Ring buffer to write to.
   * @param  result: Pointer to the button result to be written.
   * @retval true if written successfully, false if the buffer is full.
   */
-static uint8_t bits_btn_write_buffer_c11(bits_btn_result_t *result)
+static uint8_t bits_btn_try_write_buffer_c11(bits_btn_ring_buffer_t *buf, const bits_btn_result_t *result)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
-    if(result == NULL)
-        return false;
-
     size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
-    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_consume);
-
-    // Calculate the next write position (using modulo operation)
-    size_t next_write = (current_write + 1) % BITS_BTN_BUFFER_SIZE;
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_acquire);
 
-    if (next_write == current_read) {  // Buffer is full
-        atomic_fetch_add_explicit(&overwrite_count, 1, memory_order_relaxed);
+    if (current_write - current_read == buf->size)
         return false;
-    }
 
-    buf->buffer[current_write] = *result;
+    buf->slots[current_write & (buf->size - 1)] = *result;
 
-    // Update the write index (ensure data is visible to other threads)
-    atomic_store_explicit(&buf->write_idx, next_write, memory_order_release);
+    atomic_store_explicit(&buf->write_idx, current_write + 1, memory_order_release);
     return true;
 }
-#endif
 
 /**
-  * @brief  Write a button result to the ring buffer with overwrite in a single-writer scenario.
+  * @brief  Write a button result to the ring buffer, dropping the oldest result when full.
+  * @param  buf: Ring buffer to write to.
   * @param  result: Pointer to the button result to be written.
   * @retval true if written successfully.
   */
-static uint8_t bits_btn_write_buffer_overwrite_c11(bits_btn_result_t *result)
+static uint8_t bits_btn_write_buffer_overwrite_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
     if(result == NULL)
         return false;
-    // Get the current write position
+
     size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
-    size_t next_write = (current_write + 1) % BITS_BTN_BUFFER_SIZE;
     size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_acquire);
 
-
-    // Advance the read pointer when the buffer is full
-    if (next_write == current_read) {
-        atomic_fetch_add_explicit(&overwrite_count, 1, memory_order_relaxed);
-        size_t new_read = (current_read + 1) % BITS_BTN_BUFFER_SIZE;
-
-        atomic_store_explicit(&buf->read_idx, new_read, memory_order_release);
-        current_read = new_read;
+    if (current_write - current_read == buf->size)
+    {
+        // A failed exchange means the consumer freed the slot meanwhile
+        if (atomic_compare_exchange_strong_explicit(&buf->read_idx, &current_read, current_read + 1,
+                                                    memory_order_acq_rel, memory_order_acquire))
+        {
+            atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+        }
     }
 
-    // Write data (space is guaranteed to be safe at this point)
-    buf->buffer[current_write] = *result;
+    buf->slots[current_write & (buf->size - 1)] = *result;
 
-    // Update the write pointer (ensure data is visible before index update)
-    atomic_store_explicit(&buf->write_idx, next_write, memory_order_release);
+    atomic_store_explicit(&buf->write_idx, current_write + 1, memory_order_release);
     return true;
 }
 
 /**
   * @brief  Read a button result from the ring buffer.
+  * @param  buf: Ring buffer to read from.
   * @param  result: Pointer to store the read button result.
   * @retval true if read successfully, false if the buffer is empty.
   */
-static uint8_t bits_btn_read_buffer_c11(bits_btn_result_t *result)
+static uint8_t bits_btn_read_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
-    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
     size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
 
-    if (current_read == current_write) {  // Buffer is empty
-        return false;
-    }
+    for (;;)
+    {
+        size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
 
-    *result = buf->buffer[current_read];
+        if (current_read == current_write)
+            return false;
 
-    // Update the read index (using modulo operation)
-    atomic_store_explicit(&buf->read_idx, (current_read + 1) % BITS_BTN_BUFFER_SIZE, memory_order_release);
+        *result = buf->slots[current_read & (buf->size - 1)];
 
-    return true;
+        // Fails only if the producer dropped this result meanwhile; current_read is reloaded
+        if (atomic_compare_exchange_weak_explicit(&buf->read_idx, &current_read, current_read + 1,
+                                                  memory_order_release, memory_order_relaxed))
+            return true;
+    }
+}
+
+/**
+  * @brief  Read up to max button results from the ring buffer in one pass.
+  *         The run is copied in at most two segments around the wrap and the
+  *         read index is claimed once for the whole run.
+  * @param  buf: Ring buffer to read from.
+  * @param  out: Array receiving the results, oldest first.
+  * @param  max: Capacity of out.
+  * @retval Number of results read, 0 if the buffer is empty.
+  */
+static size_t bits_btn_read_batch_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *out, size_t max)
+{
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
+
+    for (;;)
+    {
+        size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
+        size_t count = current_write - current_read;
+
+        // A stale current_read may lag more than a full ring; the exchange below then fails
+        if (count > buf->size)
+            count = buf->size;
+        if (count > max)
+            count = max;
+        if (count == 0)
+            return 0;
+
+        size_t slot = current_read & (buf->size - 1);
+        size_t first = buf->size - slot;
+        if (first > count)
+            first = count;
+
+        memcpy(out, &buf->slots[slot], first * sizeof(bits_btn_result_t));
+        memcpy(out + first, &buf->slots[0], (count - first) * sizeof(bits_btn_result_t));
+
+        if (atomic_compare_exchange_weak_explicit(&buf->read_idx, &current_read, current_read + count,
+                                                  memory_order_release, memory_order_relaxed))
+            return count;
+    }
 }
 
 /**
  * @brief  Peek a button result from the ring buffer without removing it.
+ * @param  buf: Ring buffer to peek.
  * @param  result: Pointer to store the peeked button result.
  * @retval true if peek successfully, false if the buffer is empty.
  */
-static uint8_t bits_btn_peek_buffer_c11(bits_btn_result_t *result)
+static uint8_t bits_btn_peek_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
 {
-    bits_btn_ring_buffer_t *buf = &ring_buffer;
-
-    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
     size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
 
     if (current_read == current_write) {  // Buffer is empty
         return false;
     }
 
-    *result = buf->buffer[current_read];  // Read without moving the read pointer
+    *result = buf->slots[current_read & (buf->size - 1)];
 
     return true;
 }
 
-const bits_btn_buffer_ops_t c11_buffer_ops = {
-    .init = bits_btn_init_buffer_c11,
-    .write = bits_btn_write_buffer_overwrite_c11,
-    .read = bits_btn_read_buffer_c11,
-    .is_empty = bits_btn_is_buffer_empty_c11,
-    .is_full = bits_btn_is_buffer_full_c11,
-    .get_buffer_used_count = get_bits_btn_buffer_used_count_c11,
-    .clear = bits_btn_clear_buffer_c11,
-    .get_buffer_overwrite_count = get_bits_btn_buffer_overwrite_count_c11,
-    .get_buffer_capacity = get_bits_btn_buffer_capacity_c11,
-    .peek = bits_btn_peek_buffer_c11,  // Add peek function to the structure
-};
-
-static const bits_btn_buffer_ops_t *bits_btn_buffer_ops = &c11_buffer_ops;
+/**
+  * @brief  Make room in a full ring by dropping its oldest long press repeat.
+  *         read_idx is swapped to write_idx while the older results are shifted
+  *         up one slot over the repeat, so a consumer copying meanwhile fails
+  *         its compare-and-swap and sees an empty ring.
+  * @param  buf: Ring buffer.
+  * @retval true if the ring has room now, false if it holds no repeat.
+  */
+static uint8_t bits_btn_evict_repeat_c11(bits_btn_ring_buffer_t *buf)
+{
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_acquire);
 
-#endif
+    for (;;)
+    {
+        if (current_write - current_read < buf->size)
+            return true;
+
+        size_t victim = current_read;
+        while (victim != current_write && !bits_btn_is_hold_repeat(&buf->slots[victim & (buf->size - 1)]))
+            victim++;
+        if (victim == current_write)
+            return false;
+
+        // Fails only if the consumer took results meanwhile; current_read is reloaded
+        if (!atomic_compare_exchange_strong_explicit(&buf->read_idx, &current_read, current_write,
+                                                     memory_order_acq_rel, memory_order_acquire))
+            continue;
 
-#ifndef BITS_BTN_DISABLE_BUFFER
-static bits_btn_result_user_filter_callback bits_btn_result_user_filter_cb = NULL;
+        for (size_t i = victim; i != current_read; i--)
+            buf->slots[i & (buf->size - 1)] = buf->slots[(i - 1) & (buf->size - 1)];
 
-void bits_btn_register_result_filter_callback(bits_btn_result_user_filter_callback cb)
-{
-    if(cb != NULL)
-    {
-        bits_btn_result_user_filter_cb = cb;
+        atomic_store_explicit(&buf->read_idx, current_read + 1, memory_order_release);
+        atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+        return true;
     }
 }
-#endif
 
-/**
-  * @brief  Find the index of a button object by its key ID within the button array.
-  *         This is a helper function used internally to map a key ID to its corresponding
-  *         index in the button array initialized via `bits_button_init()`.
-  *
-  * @param  key_id: The unique identifier of the button to locate.
-  *
-  * @retval Index of the button in the array if found (0 to N-1), or -1 if the key ID is invalid.
-  */
-static int _get_btn_index_by_key_id(uint16_t key_id)
-{
-    bits_button_t *button = &bits_btn_entity;
-    for (size_t i = 0; i < button->btns_cnt; i++)
-    {
-        if (button->btns[i].key_id == key_id)
-        {
-            return i;
-        }
-    }
+#else
+// Modulo ring: indices stay within the slots and one slot is kept free. As in
+// the power-of-two ring, the producer drops results by moving read_idx with a
+// compare-and-swap and the consumer claims results with a compare-and-swap, so
+// a result the producer dropped or moved under the consumer is never returned.
 
-    return -1;
+// Advance a slot index by one, wrapping with a compare instead of a division
+static inline size_t bits_btn_ring_next(const bits_btn_ring_buffer_t *buf, size_t idx)
+{
+    idx++;
+    return (idx == buf->size) ? 0 : idx;
 }
 
-static uint32_t get_button_tick(void)
+static uint8_t bits_btn_is_buffer_empty_c11(bits_btn_ring_buffer_t *buf)
 {
-    return bits_btn_entity.btn_tick;
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    return current_read == current_write;
 }
 
-uint8_t bits_btn_is_buffer_empty(void)
+static uint8_t bits_btn_is_buffer_full_c11(bits_btn_ring_buffer_t *buf)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->is_empty)
-    {
-        return bits_btn_buffer_ops->is_empty();
-    }
-    return true;
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
+    return bits_btn_ring_next(buf, current_write) == current_read;
 }
 
-uint8_t bits_btn_is_buffer_full(void)
+static size_t get_bits_btn_buffer_used_count_c11(bits_btn_ring_buffer_t *buf)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->is_full)
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
+
+    if (current_write >= current_read)
     {
-        return bits_btn_buffer_ops->is_full();
+        return current_write - current_read;
+    }
+    else
+    {
+        return buf->size - current_read + current_write;
     }
-    return true;
 }
 
-size_t get_bits_btn_buffer_used_count(void)
+static size_t get_bits_btn_buffer_capacity_c11(bits_btn_ring_buffer_t *buf)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->get_buffer_used_count)
-    {
-        return bits_btn_buffer_ops->get_buffer_used_count();
-    }
-    return 0;
+    // A circular buffer needs to reserve 1 empty slot to distinguish between full and empty states,
+    // so the actual available capacity is SIZE - 1.
+    return buf->size - 1;
 }
 
 /**
   * @brief  Clear the ring buffer. Note that additional synchronization is required in a multi-threaded environment.
+  * @param  buf: Ring buffer to clear.
   * @retval None
   */
-void bits_btn_clear_buffer(void)
+static void bits_btn_clear_buffer_c11(bits_btn_ring_buffer_t *buf)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->clear)
-    {
-        bits_btn_buffer_ops->clear();
-    }
-}
-
-size_t get_bits_btn_buffer_overwrite_count(void)
-{
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->get_buffer_overwrite_count)
-    {
-        return bits_btn_buffer_ops->get_buffer_overwrite_count();
-    }
-    return 0;
+    buf->held_valid = 0;
+    atomic_store_explicit(&buf->write_idx, 0, memory_order_release);
+    atomic_store_explicit(&buf->read_idx, 0, memory_order_release);
 }
 
-size_t get_bits_btn_buffer_capacity(void)
+static size_t get_bits_btn_buffer_overwrite_count_c11(bits_btn_ring_buffer_t *buf)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->get_buffer_capacity)
-    {
-        return bits_btn_buffer_ops->get_buffer_capacity();
-    }
-    return 0;
+    return atomic_load_explicit(&buf->overwrite_count, memory_order_relaxed);
 }
-
 /**
-  * @brief  Sort combo buttons during initialization (descending by key count)
-  * @param  button: Pointer to button object
-  * @retval None
+  * @brief  Write a button result to the ring buffer unless it is full.
+  * @param  buf: Ring buffer to write to.
+  * @param  result: Pointer to the button result to be written.
+  * @retval true if written successfully, false if the buffer is full.
   */
- static void sort_combo_buttons_in_init(bits_button_t *button)
- {
-    const uint16_t cnt = button->btns_combo_cnt;  // Get number of combo buttons
+static uint8_t bits_btn_try_write_buffer_c11(bits_btn_ring_buffer_t *buf, const bits_btn_result_t *result)
+{
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_acquire);
 
-    // Skip sorting if no combo buttons or only one
-    if (cnt <= 1)
-    {
-        if (debug_printf && cnt == 0) debug_printf("No combo buttons\n");
-        return;
+    size_t next_write = bits_btn_ring_next(buf, current_write);
+
+    if (next_write == current_read) {  // Buffer is full
+        return false;
     }
 
-    // Initialize index array (0,1,2,...)
-    for (uint16_t i = 0; i < cnt; i++)
-        button->combo_sorted_indices[i] = i;
+    buf->slots[current_write] = *result;
 
-    // Insertion sort (descending by key count)
-    for (uint16_t i = 1; i < cnt; i++)
-    {
-        const uint16_t temp_idx = button->combo_sorted_indices[i];  // Current element to insert
-        const uint8_t temp_keys = button->btns_combo[temp_idx].key_count;  // Key count of current element
-        int16_t j = i - 1;  // Start from end of sorted portion
+    // Update the write index (ensure data is visible to other threads)
+    atomic_store_explicit(&buf->write_idx, next_write, memory_order_release);
+    return true;
+}
 
-        // Find insertion position: higher key count has higher priority
-        while (j >= 0 &&
-               button->btns_combo[button->combo_sorted_indices[j]].key_count < temp_keys)
+/**
+  * @brief  Write a button result to the ring buffer with overwrite in a single-writer scenario.
+  * @param  buf: Ring buffer to write to.
+  * @param  result: Pointer to the button result to be written.
+  * @retval true if written successfully.
+  */
+static uint8_t bits_btn_write_buffer_overwrite_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
+{
+    if(result == NULL)
+        return false;
+    // Get the current write position
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t next_write = bits_btn_ring_next(buf, current_write);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_acquire);
+
+
+    // Advance the read pointer when the buffer is full; a failed exchange means the consumer freed the slot meanwhile
+    if (next_write == current_read) {
+        if (atomic_compare_exchange_strong_explicit(&buf->read_idx, &current_read, bits_btn_ring_next(buf, current_read),
+                                                    memory_order_acq_rel, memory_order_acquire))
         {
-            // Shift lower priority elements backward
-            button->combo_sorted_indices[j + 1] = button->combo_sorted_indices[j];
-            j--;
+            atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
         }
-        // Insert current element at correct position
-        button->combo_sorted_indices[j + 1] = temp_idx;
     }
 
-#if 0
-    // Debug output of sorting results
-    if (debug_printf)
+    // Write data (space is guaranteed to be safe at this point)
+    buf->slots[current_write] = *result;
+
+    // Update the write pointer (ensure data is visible before index update)
+    atomic_store_explicit(&buf->write_idx, next_write, memory_order_release);
+    return true;
+}
+
+/**
+  * @brief  Read a button result from the ring buffer.
+  * @param  buf: Ring buffer to read from.
+  * @param  result: Pointer to store the read button result.
+  * @retval true if read successfully, false if the buffer is empty.
+  */
+static uint8_t bits_btn_read_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
+{
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
+
+    for (;;)
     {
-        debug_printf("Sorted combo indices (%d):\n", cnt);
-        for (uint16_t i = 0; i < cnt; i++)
-        {
-            const button_obj_combo_t* c = &button->btns_combo[button->combo_sorted_indices[i]];
-            debug_printf("  %d: ID=%d, Keys=", i, c->btn.key_id);
-            for (uint8_t j = 0; j < c->key_count; j++)
-                debug_printf("%d ", c->key_single_ids[j]);
-            debug_printf("\n");
+        size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
+
+        if (current_read == current_write) {  // Buffer is empty
+            return false;
         }
+
+        *result = buf->slots[current_read];
+
+        // Fails only if the producer dropped or moved this result meanwhile; current_read is reloaded
+        if (atomic_compare_exchange_weak_explicit(&buf->read_idx, &current_read, bits_btn_ring_next(buf, current_read),
+                                                  memory_order_release, memory_order_relaxed))
+            return true;
     }
-#endif
 }
 
-int32_t bits_button_init(const bits_btn_config_t *config)
+/**
+  * @brief  Read up to max button results from the ring buffer in one pass.
+  *         The run is copied in at most two segments around the wrap and the
+  *         read index is claimed once for the whole run.
+  * @param  buf: Ring buffer to read from.
+  * @param  out: Array receiving the results, oldest first.
+  * @param  max: Capacity of out.
+  * @retval Number of results read, 0 if the buffer is empty.
+  */
+static size_t bits_btn_read_batch_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *out, size_t max)
 {
-    bits_button_t *button = &bits_btn_entity;
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
 
-    if (config == NULL)
+    for (;;)
     {
-        return BITS_BTN_ERR_INVALID_PARAM;
+        size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
+        size_t count = (current_write >= current_read) ? current_write - current_read
+                                                       : buf->size - current_read + current_write;
+
+        if (count > max)
+            count = max;
+        if (count == 0)
+            return 0;
+
+        size_t first = buf->size - current_read;
+        if (first > count)
+            first = count;
+
+        memcpy(out, &buf->slots[current_read], first * sizeof(bits_btn_result_t));
+        memcpy(out + first, &buf->slots[0], (count - first) * sizeof(bits_btn_result_t));
+
+        size_t new_read = current_read + count;
+        if (new_read >= buf->size)
+            new_read -= buf->size;
+        if (atomic_compare_exchange_weak_explicit(&buf->read_idx, &current_read, new_read,
+                                                  memory_order_release, memory_order_relaxed))
+            return count;
     }
+}
 
-    debug_printf = config->bits_btn_debug_printf;
+/**
+ * @brief  Peek a button result from the ring buffer without removing it.
+ * @param  buf: Ring buffer to peek.
+ * @param  result: Pointer to store the peeked button result.
+ * @retval true if peek successfully, false if the buffer is empty.
+ */
+static uint8_t bits_btn_peek_buffer_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
+{
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_acquire);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_relaxed);
 
-    if ((config->btns == NULL)
-    || (config->btns_cnt == 0)
-    || (config->read_button_level_func == NULL)
-    || (config->btns_combo_cnt > 0 && config->btns_combo == NULL))
-    {
-        if(debug_printf)
-            debug_printf("Invalid init parameters !\n");
-        return BITS_BTN_ERR_INVALID_PARAM;
+    if (current_read == current_write) {  // Buffer is empty
+        return false;
     }
 
-    if (config->btns_cnt > BITS_BTN_MAX_BUTTONS)
-    {
-        if (debug_printf)
-            debug_printf("Error: Too many buttons (%d > max %d)\n", config->btns_cnt, (int)BITS_BTN_MAX_BUTTONS);
-        return BITS_BTN_ERR_TOO_MANY_BUTTONS;
-    }
+    *result = buf->slots[current_read];  // Read without moving the read pointer
 
-    memset(button, 0, sizeof(bits_button_t));
+    return true;
+}
 
-    button->btns = config->btns;
-    button->btns_cnt = config->btns_cnt;
-    button->btns_combo = config->btns_combo;
-    button->btns_combo_cnt = config->btns_combo_cnt;
-    button->_read_button_level = config->read_button_level_func;
-    button->bits_btn_result_cb = config->bits_btn_result_cb;
+/**
+  * @brief  Make room in a full ring by dropping its oldest long press repeat.
+  *         read_idx is swapped to write_idx while the older results are shifted
+  *         up one slot over the repeat, so a consumer copying meanwhile fails
+  *         its compare-and-swap and sees an empty ring.
+  * @param  buf: Ring buffer.
+  * @retval true if the ring has room now, false if it holds no repeat.
+  */
+static uint8_t bits_btn_evict_repeat_c11(bits_btn_ring_buffer_t *buf)
+{
+    size_t current_write = atomic_load_explicit(&buf->write_idx, memory_order_relaxed);
+    size_t current_read = atomic_load_explicit(&buf->read_idx, memory_order_acquire);
 
-    if (config->btns_combo_cnt > BITS_BTN_MAX_COMBO_BUTTONS)
+    for (;;)
     {
-        if (debug_printf)
-        {
-            debug_printf("Error: Too many combo buttons (%d > max %d)\n",
-                         config->btns_combo_cnt, BITS_BTN_MAX_COMBO_BUTTONS);
-        }
-        return BITS_BTN_ERR_TOO_MANY_COMBOS;
-    }
+        if (bits_btn_ring_next(buf, current_write) != current_read)
+            return true;
+
+        size_t victim = current_read;
+        while (victim != current_write && !bits_btn_is_hold_repeat(&buf->slots[victim]))
+            victim = bits_btn_ring_next(buf, victim);
+        if (victim == current_write)
+            return false;
+
+        // Fails only if the consumer took results meanwhile; current_read is reloaded
+        if (!atomic_compare_exchange_strong_explicit(&buf->read_idx, &current_read, current_write,
+                                                     memory_order_acq_rel, memory_order_acquire))
+            continue;
 
-    // Check single button param pointers
-    for (uint16_t i = 0; i < config->btns_cnt; i++)
-    {
-        if (config->btns[i].param == NULL)
+        while (victim != current_read)
         {
-            if (debug_printf)
-                debug_printf("Error: Button[%d] param is NULL\n", i);
-            return BITS_BTN_ERR_BTN_PARAM_NULL;
+            size_t prev = (victim == 0) ? buf->size - 1 : victim - 1;
+            buf->slots[victim] = buf->slots[prev];
+            victim = prev;
         }
-    }
 
-    // Check combo button param pointers
-    for (uint16_t i = 0; i < config->btns_combo_cnt; i++)
-    {
-        if (config->btns_combo[i].btn.param == NULL)
-        {
-            if (debug_printf)
-                debug_printf("Error: Combo button[%d] param is NULL\n", i);
-            return BITS_BTN_ERR_COMBO_PARAM_NULL;
-        }
+        atomic_store_explicit(&buf->read_idx, bits_btn_ring_next(buf, current_read), memory_order_release);
+        atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+        return true;
     }
+}
 
-    // Check combo button keys configuration validity
-    for (uint16_t i = 0; i < config->btns_combo_cnt; i++)
+#endif /* BITS_BTN_USE_POW2_BUFFER */
+
+// BITS_BTN_OVERFLOW_COALESCE keeps one result back in the producer-owned held
+// slot while the ring is full. Long press repeats are the only results that are
+// ever dropped: a repeat held back is replaced by the next repeat of the same
+// key, and otherwise the oldest repeat queued in the ring is evicted to make
+// room. Press, release, finish and long press start results are only dropped
+// once the ring and the held slot are all such results; the newest result is
+// then rejected. The held result is published as soon as the ring has room again.
+
+/**
+  * @brief  Publish the held result if the ring has room for it.
+  * @param  buf: Ring buffer.
+  * @retval None
+  */
+static void bits_btn_flush_held_c11(bits_btn_ring_buffer_t *buf)
+{
+    if (buf->held_valid && bits_btn_try_write_buffer_c11(buf, &buf->held))
     {
-        if (config->btns_combo[i].key_single_ids == NULL ||
-            config->btns_combo[i].key_count == 0)
-        {
-            if (debug_printf)
-                debug_printf("Error: Combo button[%d] has invalid keys config (key_single_ids=%p, key_count=%d)\n",
-                             i,
-                             (void*)config->btns_combo[i].key_single_ids,
-                             config->btns_combo[i].key_count);
-            return BITS_BTN_ERR_COMBO_KEYS_INVALID;
-        }
+        buf->held_valid = 0;
+#ifdef BITS_BTN_ENABLE_STATS
+        buf->held_published++;
+#endif
     }
+}
 
-    for(uint16_t i = 0; i < config->btns_combo_cnt; i++)
-    {
-        button_obj_combo_t *combo = &button->btns_combo[i];
-        combo->combo_mask = 0;
+/**
+  * @brief  Write a button result, holding it back when the ring is full.
+  * @param  buf: Ring buffer to write to.
+  * @param  result: Pointer to the button result to be written.
+  * @retval true if the result was queued or held, false if it was dropped.
+  */
+static uint8_t bits_btn_write_buffer_coalesce_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
+{
+    bits_btn_flush_held_c11(buf);
 
-        for(uint16_t j = 0; j < combo->key_count; j++)
+    if (!buf->held_valid)
+    {
+        if (!bits_btn_try_write_buffer_c11(buf, result))
         {
-            int idx = _get_btn_index_by_key_id(combo->key_single_ids[j]);
-            if (idx == -1)
-            {
-                if(debug_printf)
-                    debug_printf("Error, get_btn_index failed! \n");
-                return BITS_BTN_ERR_INVALID_COMBO_ID;
-            }
-            combo->combo_mask |= ((button_mask_type_t)1UL << idx);
+            buf->held = *result;
+            buf->held_valid = 1;
         }
+        return true;
     }
 
-    // Sort the combination buttons during initialization.
-    sort_combo_buttons_in_init(button);
-
-#ifdef BITS_BTN_USE_USER_BUFFER
-    if (bits_btn_buffer_ops == NULL)
+    // The ring is full and a result is already held back
+    uint8_t held_repeat = bits_btn_is_hold_repeat(&buf->held);
+    if (held_repeat && bits_btn_is_hold_repeat(result) && buf->held.key_id == result->key_id)
     {
-        if (debug_printf) debug_printf("Error: External buffer mode requires setting buffer ops!\n");
-        return BITS_BTN_ERR_BUFFER_OPS_NULL;
+        // The newer repeat of the same key carries the latest trigger count
+        atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+        buf->held = *result;
+        return true;
     }
+    if (bits_btn_evict_repeat_c11(buf))
+    {
+        bits_btn_try_write_buffer_c11(buf, &buf->held);
+#ifdef BITS_BTN_ENABLE_STATS
+        buf->held_published++;
 #endif
-
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->init)
+        buf->held = *result;
+        return true;
+    }
+    if (held_repeat)
     {
-        bits_btn_buffer_ops->init();
+        atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+        buf->held = *result;
+        return true;
     }
 
-    return BITS_BTN_OK;
+    atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+    return false;
 }
 
 /**
-  * @brief  Get the button key result from the buffer.
-  * @param  result: Pointer to store the button key result
-  * @retval true if read successfully, false if the buffer is empty.
+  * @brief  Write a button result according to the ring's overflow policy.
+  * @param  buf: Ring buffer to write to.
+  * @param  result: Pointer to the button result to be written.
+  * @retval true if the result was queued or held, false if it was dropped.
   */
-uint8_t bits_button_get_key_result(bits_btn_result_t *result)
+static uint8_t bits_btn_write_buffer_policy_c11(bits_btn_ring_buffer_t *buf, bits_btn_result_t *result)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->read)
+    if(result == NULL)
+        return false;
+
+    switch (buf->overflow_policy)
     {
-        return bits_btn_buffer_ops->read(result);
+        case BITS_BTN_OVERFLOW_DROP_NEWEST:
+            if (bits_btn_try_write_buffer_c11(buf, result))
+                return true;
+            atomic_fetch_add_explicit(&buf->overwrite_count, 1, memory_order_relaxed);
+            return false;
+        case BITS_BTN_OVERFLOW_COALESCE:
+            return bits_btn_write_buffer_coalesce_c11(buf, result);
+        case BITS_BTN_OVERFLOW_OVERWRITE_OLDEST:
+        default:
+            return bits_btn_write_buffer_overwrite_c11(buf, result);
     }
-    return false;
 }
 
-/**
- * @brief  Peek the button key result from the buffer without removing it.
- * @param  result: Pointer to store the button key result
- * @retval true(1) if peek successfully, false if the buffer is empty.
- */
-uint8_t bits_button_peek_key_result(bits_btn_result_t *result)
+#endif
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+void bits_btn_register_result_filter_callback_ctx(bits_button_t *button, bits_btn_result_user_filter_callback cb)
 {
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->peek)
+    if(cb != NULL)
     {
-        return bits_btn_buffer_ops->peek(result);
+        button->result_user_filter_cb = cb;
     }
-    return false;
 }
 
+void bits_btn_register_result_filter_callback(bits_btn_result_user_filter_callback cb)
+{
+    bits_btn_register_result_filter_callback_ctx(&bits_btn_entity, cb);
+}
+#endif
+
+#if defined(BITS_BTN_ENABLE_KEY_MAP) && BITS_BTN_KEY_MAP_SIZE < BITS_BTN_MAX_BUTTONS + BITS_BTN_MAX_COMBO_BUTTONS
+#error "BITS_BTN_KEY_MAP_SIZE must have room for every single and combo button"
+#endif
+
 /**
-  * @brief  Reset all button states to idle.
-  *         This function should be called when resuming from low power mode
-  *         to clear any residual button states from before the pause.
+  * @brief  Get a button object by its key map index.
+  * @param  button: Pointer to the bits button object.
+  * @param  index: Index into btns, followed by the indices of btns_combo.
+  * @retval Pointer to the button object.
+  */
+static struct button_obj_t *get_btn_by_map_index(bits_button_t *button, size_t index)
+{
+    if (index < button->btns_cnt)
+        return &button->btns[index];
+
+    return &button->btns_combo[index - button->btns_cnt].btn;
+}
+
+#ifdef BITS_BTN_ENABLE_KEY_MAP
+/**
+  * @brief  Build the open-addressing key_id -> index map used for O(1) lookups.
+  *         Single buttons come first, then combo buttons; the first button with a
+  *         given key ID wins, like the linear scan it replaces.
+  * @param  button: Pointer to the bits button object.
   * @retval None
   */
-void bits_button_reset_states(void)
+static void build_key_index_map(bits_button_t *button)
 {
-    bits_button_t *button = &bits_btn_entity;
+    size_t total = (size_t)button->btns_cnt + button->btns_combo_cnt;
 
-    if (debug_printf)
-        debug_printf("Resetting all button states\n");
+    memset(button->key_index_map, 0, sizeof(button->key_index_map));
+
+    for (size_t index = 0; index < total; index++)
+    {
+        uint16_t key_id = get_btn_by_map_index(button, index)->key_id;
+        size_t slot = key_id % BITS_BTN_KEY_MAP_SIZE;
+
+        while (button->key_index_map[slot] != 0)
+        {
+            if (get_btn_by_map_index(button, button->key_index_map[slot] - 1)->key_id == key_id)
+                break;
+            slot = (slot + 1) % BITS_BTN_KEY_MAP_SIZE;
+        }
+
+        if (button->key_index_map[slot] == 0)
+            button->key_index_map[slot] = (uint16_t)(index + 1);
+    }
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+/**
+  * @brief  Precompute the tick thresholds of every single and combo button.
+  *         time_diff * BITS_BTN_TICKS_INTERVAL > ms holds exactly when time_diff > ms / BITS_BTN_TICKS_INTERVAL.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void build_tick_params(bits_button_t *button)
+{
+    size_t total = (size_t)button->btns_cnt + button->btns_combo_cnt;
+
+    for (size_t index = 0; index < total; index++)
+    {
+        const bits_btn_obj_param_t *param = get_btn_by_map_index(button, index)->param;
+        bits_btn_tick_param_t *tick_param = &button->tick_params[index];
+
+        tick_param->timeout_ticks[0] = 0;
+        tick_param->timeout_ticks[1] = param->long_press_start_time_ms / BITS_BTN_TICKS_INTERVAL;
+        tick_param->timeout_ticks[2] = param->long_press_period_triger_ms / BITS_BTN_TICKS_INTERVAL;
+        tick_param->timeout_ticks[3] = param->time_window_time_ms / BITS_BTN_TICKS_INTERVAL;
+    }
+}
+#endif
+
+/**
+  * @brief  Find the index of a button object by its key ID.
+  *         Uses the key map built in `bits_button_init()` when BITS_BTN_ENABLE_KEY_MAP
+  *         is defined, otherwise scans the single buttons, then the combo buttons.
+  *
+  * @param  button: Pointer to the bits button object.
+  * @param  key_id: The unique identifier of the button to locate.
+  *
+  * @retval Index of the button (0 to N-1 for single buttons, N and up for combo buttons),
+  *         or -1 if the key ID is invalid.
+  */
+static int _get_btn_index_by_key_id(bits_button_t *button, uint16_t key_id)
+{
+#ifdef BITS_BTN_ENABLE_KEY_MAP
+    size_t slot = key_id % BITS_BTN_KEY_MAP_SIZE;
+
+    for (size_t probe = 0; probe < BITS_BTN_KEY_MAP_SIZE; probe++)
+    {
+        uint16_t entry = button->key_index_map[slot];
+
+        if (entry == 0)
+            break;
+        if (get_btn_by_map_index(button, entry - 1)->key_id == key_id)
+            return entry - 1;
+        slot = (slot + 1) % BITS_BTN_KEY_MAP_SIZE;
+    }
+#else
+    size_t total = (size_t)button->btns_cnt + button->btns_combo_cnt;
+
+    for (size_t index = 0; index < total; index++)
+    {
+        if (get_btn_by_map_index(button, index)->key_id == key_id)
+            return (int)index;
+    }
+#endif
+
+    return -1;
+}
+
+// ============================================================================
+// Pattern Trie
+// ============================================================================
+// The key_values registered for a key form a binary trie walked from the first
+// press (the highest set bit) down. When a release appends its 0 and the bits
+// leave the trie or reach a node without children, no further press can lead
+// to a registered pattern, so the key finishes without waiting out its window.
+
+#ifdef BITS_BTN_ENABLE_PATTERNS
+/**
+  * @brief  Take a node from the trie pool.
+  * @param  button: Pointer to the bits button object.
+  * @retval Node + 1, or 0 when the pool is exhausted.
+  */
+static uint16_t pattern_node_alloc(bits_button_t *button)
+{
+    if (button->pattern_node_cnt >= BITS_BTN_MAX_PATTERN_NODES)
+        return 0;
+
+    uint16_t node = button->pattern_node_cnt++;
+    button->pattern_nodes[node][0] = 0;
+    button->pattern_nodes[node][1] = 0;
+    return node + 1;
+}
+
+/**
+  * @brief  Compile the registered pattern sets into tries and attach them to their keys.
+  * @param  button: Pointer to the bits button object.
+  * @param  config: Configuration holding the pattern sets.
+  * @retval BITS_BTN_OK, BITS_BTN_ERR_INVALID_PARAM, BITS_BTN_ERR_KEY_NOT_FOUND or BITS_BTN_ERR_TOO_MANY_PATTERNS.
+  */
+static int32_t build_pattern_tries(bits_button_t *button, const bits_btn_config_t *config)
+{
+    button->pattern_node_cnt = 0;
+    memset(button->pattern_roots, 0, sizeof(button->pattern_roots));
+
+    for (uint16_t s = 0; s < config->pattern_sets_cnt; s++)
+    {
+        const bits_btn_pattern_set_t *set = &config->pattern_sets[s];
+        int index = _get_btn_index_by_key_id(button, set->key_id);
+        uint16_t root = 0;
+
+        if (set->patterns == NULL || set->pattern_cnt == 0)
+            return BITS_BTN_ERR_INVALID_PARAM;
+        if (index < 0)
+            return BITS_BTN_ERR_KEY_NOT_FOUND;
+
+        // Keys registering the same array share its trie
+        for (uint16_t p = 0; p < s && root == 0; p++)
+        {
+            if (config->pattern_sets[p].patterns == set->patterns && config->pattern_sets[p].pattern_cnt == set->pattern_cnt)
+                root = button->pattern_roots[_get_btn_index_by_key_id(button, config->pattern_sets[p].key_id)];
+        }
+
+        if (root == 0)
+        {
+            root = pattern_node_alloc(button);
+            if (root == 0)
+                return BITS_BTN_ERR_TOO_MANY_PATTERNS;
+
+            for (uint8_t n = 0; n < set->pattern_cnt; n++)
+            {
+                state_bits_type_t pattern = set->patterns[n];
+                uint16_t node = root;
+                int b = 31;
+
+                if (pattern == 0)
+                    return BITS_BTN_ERR_INVALID_PARAM;
+                while (((pattern >> b) & 1U) == 0)
+                    b--;
+
+                for (; b >= 0; b--)
+                {
+                    uint16_t *child = &button->pattern_nodes[node - 1][(pattern >> b) & 1U];
+
+                    if (*child == 0)
+                    {
+                        *child = pattern_node_alloc(button);
+                        if (*child == 0)
+                            return BITS_BTN_ERR_TOO_MANY_PATTERNS;
+                    }
+                    node = *child;
+                }
+            }
+        }
+
+        button->pattern_roots[index] = root;
+    }
+
+    return BITS_BTN_OK;
+}
+
+/**
+  * @brief  Check whether state_bits can still grow into one of the key's registered patterns.
+  * @param  button: Pointer to the bits button object.
+  * @param  index: Index of the key, combo buttons follow the single buttons.
+  * @param  bits: state_bits after the release.
+  * @retval 1 if no registered pattern is reachable any more, 0 otherwise or when the key registered none.
+  */
+static uint8_t pattern_is_final(const bits_button_t *button, size_t index, state_bits_type_t bits)
+{
+    uint16_t root = button->pattern_roots[index];
+    uint16_t node = root;
+    int b = 31;
+
+    if (root == 0)
+        return 0;
+
+    while (b > 0 && ((bits >> b) & 1U) == 0)
+        b--;
+
+    for (; b >= 0; b--)
+    {
+        node = button->pattern_nodes[node - 1][(bits >> b) & 1U];
+        if (node == 0)
+            return 1;
+    }
+
+    return button->pattern_nodes[node - 1][0] == 0 && button->pattern_nodes[node - 1][1] == 0;
+}
+#else
+static inline uint8_t pattern_is_final(const bits_button_t *button, size_t index, state_bits_type_t bits)
+{
+    (void)button;
+    (void)index;
+    (void)bits;
+    return 0;
+}
+#endif
+
+// ============================================================================
+// Handler Table
+// ============================================================================
+// Registered handlers are hashed on (key_id, event, key_value) into an open
+// addressing table at init, so dispatching a result costs one probe chain for
+// its exact key_value and one for the BITS_BTN_ANY_KEY_VALUE fallback.
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+static inline size_t handler_slot(uint16_t key_id, uint8_t event, state_bits_type_t key_value)
+{
+    uint32_t h = ((uint32_t)key_id << 8 | event) * 0x9E3779B1U ^ (uint32_t)key_value * 0x85EBCA6BU;
+    return (size_t)((h ^ (h >> 16)) % BITS_BTN_HANDLER_MAP_SIZE);
+}
+
+/**
+  * @brief  Find a registered handler.
+  * @param  button: Pointer to the bits button object.
+  * @retval The handler entry, or NULL if none is registered for exactly this triple.
+  */
+static const bits_btn_handler_t *handler_find(const bits_button_t *button, uint16_t key_id, uint8_t event, state_bits_type_t key_value)
+{
+    size_t slot = handler_slot(key_id, event, key_value);
+
+    for (size_t probe = 0; probe < BITS_BTN_HANDLER_MAP_SIZE; probe++)
+    {
+        uint16_t entry = button->handler_map[slot];
+
+        if (entry == 0)
+            break;
+
+        const bits_btn_handler_t *h = &button->handlers[entry - 1];
+        if (h->key_id == key_id && h->event == event && h->key_value == key_value)
+            return h;
+        slot = (slot + 1) % BITS_BTN_HANDLER_MAP_SIZE;
+    }
+
+    return NULL;
+}
+
+/**
+  * @brief  Compile the registered handlers into the handler table.
+  * @param  button: Pointer to the bits button object.
+  * @param  config: Configuration holding the handlers.
+  * @retval BITS_BTN_OK, BITS_BTN_ERR_INVALID_PARAM, BITS_BTN_ERR_KEY_NOT_FOUND or BITS_BTN_ERR_TOO_MANY_HANDLERS.
+  */
+static int32_t build_handler_map(bits_button_t *button, const bits_btn_config_t *config)
+{
+    if (config->handlers_cnt > BITS_BTN_HANDLER_MAP_SIZE)
+        return BITS_BTN_ERR_TOO_MANY_HANDLERS;
+
+    button->handlers = (config->handlers_cnt > 0) ? config->handlers : NULL;
+    button->handlers_on_drain = config->handlers_on_drain;
+
+    for (uint16_t i = 0; i < config->handlers_cnt; i++)
+    {
+        const bits_btn_handler_t *h = &config->handlers[i];
+
+        if (h->handler == NULL)
+            return BITS_BTN_ERR_INVALID_PARAM;
+        if (h->event != BTN_EVENT_PRESSED && h->event != BTN_EVENT_LONG_PRESS
+         && h->event != BTN_EVENT_RELEASE && h->event != BTN_EVENT_FINISH)
+            return BITS_BTN_ERR_INVALID_PARAM;
+        if (_get_btn_index_by_key_id(button, h->key_id) < 0)
+            return BITS_BTN_ERR_KEY_NOT_FOUND;
+        // A second handler for the same triple would never run
+        if (handler_find(button, h->key_id, h->event, h->key_value) != NULL)
+            return BITS_BTN_ERR_INVALID_PARAM;
+
+        size_t slot = handler_slot(h->key_id, h->event, h->key_value);
+        while (button->handler_map[slot] != 0)
+            slot = (slot + 1) % BITS_BTN_HANDLER_MAP_SIZE;
+        button->handler_map[slot] = (uint16_t)(i + 1);
+    }
+
+    return BITS_BTN_OK;
+}
+#endif
+
+// ============================================================================
+// Button State Snapshot (sequence lock)
+// ============================================================================
+// A tick makes state_seq odd while it updates the button states, so readers in
+// another context can detect a torn snapshot and retry. Without the C11 ring
+// the counter is a volatile, ordered against the state by full fences on
+// GCC and Clang; other compilers must define BITS_BTN_STATE_FENCE() as their
+// memory barrier, or snapshots are not reliable.
+
+#if !defined(BITS_BTN_USE_C11_BUFFER) && !defined(BITS_BTN_STATE_FENCE)
+#if defined(__GNUC__) || defined(__clang__)
+#define BITS_BTN_STATE_FENCE()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define BITS_BTN_STATE_FENCE()  ((void)0)
+#endif
+#endif
+
+static inline void bits_btn_state_write_begin(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    size_t seq = atomic_load_explicit(&button->state_seq, memory_order_relaxed);
+    atomic_store_explicit(&button->state_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+#else
+    button->state_seq++;
+    BITS_BTN_STATE_FENCE();
+#endif
+}
+
+static inline void bits_btn_state_write_end(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    size_t seq = atomic_load_explicit(&button->state_seq, memory_order_relaxed);
+    atomic_store_explicit(&button->state_seq, seq + 1, memory_order_release);
+#else
+    BITS_BTN_STATE_FENCE();
+    button->state_seq++;
+#endif
+}
+
+static inline size_t bits_btn_state_read_begin(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return atomic_load_explicit(&button->state_seq, memory_order_acquire);
+#else
+    size_t seq = button->state_seq;
+    BITS_BTN_STATE_FENCE();
+    return seq;
+#endif
+}
+
+static inline uint8_t bits_btn_state_read_retry(bits_button_t *button, size_t seq)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    atomic_thread_fence(memory_order_acquire);
+    return (seq & 1U) || seq != atomic_load_explicit(&button->state_seq, memory_order_relaxed);
+#else
+    BITS_BTN_STATE_FENCE();
+    return (seq & 1U) || seq != button->state_seq;
+#endif
+}
+
+static uint32_t get_button_tick(bits_button_t *button)
+{
+    return button->btn_tick;
+}
+
+uint8_t bits_btn_is_buffer_empty_ctx(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return bits_btn_is_buffer_empty_c11(&button->ring_buffer);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->is_empty)
+    {
+        return bits_btn_buffer_ops->is_empty();
+    }
+    return true;
+#endif
+}
+
+uint8_t bits_btn_is_buffer_empty(void)
+{
+    return bits_btn_is_buffer_empty_ctx(&bits_btn_entity);
+}
+
+uint8_t bits_btn_is_buffer_full_ctx(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return bits_btn_is_buffer_full_c11(&button->ring_buffer);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->is_full)
+    {
+        return bits_btn_buffer_ops->is_full();
+    }
+    return true;
+#endif
+}
+
+uint8_t bits_btn_is_buffer_full(void)
+{
+    return bits_btn_is_buffer_full_ctx(&bits_btn_entity);
+}
+
+size_t get_bits_btn_buffer_used_count_ctx(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return get_bits_btn_buffer_used_count_c11(&button->ring_buffer);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->get_buffer_used_count)
+    {
+        return bits_btn_buffer_ops->get_buffer_used_count();
+    }
+    return 0;
+#endif
+}
+
+size_t get_bits_btn_buffer_used_count(void)
+{
+    return get_bits_btn_buffer_used_count_ctx(&bits_btn_entity);
+}
+
+/**
+  * @brief  Clear the ring buffer. Note that additional synchronization is required in a multi-threaded environment.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void bits_btn_clear_buffer_ctx(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    bits_btn_clear_buffer_c11(&button->ring_buffer);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->clear)
+    {
+        bits_btn_buffer_ops->clear();
+    }
+#endif
+}
+
+/**
+  * @brief  Clear the ring buffer. Note that additional synchronization is required in a multi-threaded environment.
+  * @retval None
+  */
+void bits_btn_clear_buffer(void)
+{
+    bits_btn_clear_buffer_ctx(&bits_btn_entity);
+}
+
+size_t get_bits_btn_buffer_overwrite_count_ctx(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return get_bits_btn_buffer_overwrite_count_c11(&button->ring_buffer);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->get_buffer_overwrite_count)
+    {
+        return bits_btn_buffer_ops->get_buffer_overwrite_count();
+    }
+    return 0;
+#endif
+}
+
+size_t get_bits_btn_buffer_overwrite_count(void)
+{
+    return get_bits_btn_buffer_overwrite_count_ctx(&bits_btn_entity);
+}
+
+size_t get_bits_btn_buffer_capacity_ctx(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return get_bits_btn_buffer_capacity_c11(&button->ring_buffer);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->get_buffer_capacity)
+    {
+        return bits_btn_buffer_ops->get_buffer_capacity();
+    }
+    return 0;
+#endif
+}
+
+size_t get_bits_btn_buffer_capacity(void)
+{
+    return get_bits_btn_buffer_capacity_ctx(&bits_btn_entity);
+}
+
+#ifdef BITS_BTN_HAS_READER_NOTIFY
+// ============================================================================
+// Reader Notification
+// ============================================================================
+// Readers that go to sleep announce it first: a blocking reader counts itself
+// in wait_parked, and a reader that drained the ring sets event_fd_armed. Each
+// then checks the ring again. The tick publishes first and reads both flags
+// behind a full fence, so either it sees the reader and wakes it, or the
+// reader's second check sees the result. Without a sleeping reader a publish
+// costs the fence and a load or two, and no system call.
+
+/**
+  * @brief  Wake the readers sleeping on an instance after a result was published.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void bits_btn_notify_readers(bits_button_t *button)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+#ifdef BITS_BTN_ENABLE_WAIT
+    if (atomic_load_explicit(&button->wait_parked, memory_order_relaxed) != 0)
+    {
+        atomic_fetch_add_explicit(&button->wait_seq, 1, memory_order_release);
+        syscall(SYS_futex, &button->wait_seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    }
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    // Only the side that clears the flag signals, so each empty to non-empty transition writes once
+    if (atomic_load_explicit(&button->event_fd_armed, memory_order_relaxed) != 0
+        && atomic_exchange_explicit(&button->event_fd_armed, 0, memory_order_acquire) != 0)
+    {
+        eventfd_write(button->event_fd, 1);
+    }
+#endif
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENTFD
+/**
+  * @brief  Reset the descriptor once a reader found the ring empty, and arm the next signal.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void bits_btn_event_fd_rearm(bits_button_t *button)
+{
+    eventfd_t count;
+
+    // Still armed: nothing was signalled since the last reset
+    if (!button->event_fd_open || atomic_load_explicit(&button->event_fd_armed, memory_order_relaxed) != 0)
+        return;
+
+    eventfd_read(button->event_fd, &count);
+    atomic_store_explicit(&button->event_fd_armed, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    // A result published before the tick could see the flag: signal on its behalf
+    if (!bits_btn_is_buffer_empty_ctx(button)
+        && atomic_exchange_explicit(&button->event_fd_armed, 0, memory_order_relaxed) != 0)
+    {
+        eventfd_write(button->event_fd, 1);
+    }
+}
+
+/**
+  * @brief  Get the readiness descriptor of an instance, creating it on the first call.
+  * @param  button: Pointer to the bits button object.
+  * @retval Nonblocking eventfd, or -1 if it cannot be created.
+  */
+int bits_button_get_event_fd_ctx(bits_button_t *button)
+{
+    if (!button->event_fd_open)
+    {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (fd < 0)
+            return -1;
+        button->event_fd = fd;
+        button->event_fd_open = 1;
+        // Readable at once if results are already waiting
+        bits_btn_event_fd_rearm(button);
+    }
+    return button->event_fd;
+}
+
+int bits_button_get_event_fd(void)
+{
+    return bits_button_get_event_fd_ctx(&bits_btn_entity);
+}
+
+/**
+  * @brief  Close the readiness descriptor of an instance.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+void bits_button_close_event_fd_ctx(bits_button_t *button)
+{
+    if (!button->event_fd_open)
+        return;
+
+    atomic_store_explicit(&button->event_fd_armed, 0, memory_order_relaxed);
+    close(button->event_fd);
+    button->event_fd_open = 0;
+}
+
+void bits_button_close_event_fd(void)
+{
+    bits_button_close_event_fd_ctx(&bits_btn_entity);
+}
+#endif
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+/**
+  * @brief  Write a result to the instance buffer.
+  * @param  button: Pointer to the bits button object.
+  * @param  result: Pointer to the button result to be written.
+  * @retval true if written successfully.
+  */
+static uint8_t bits_btn_write_buffer_ctx(bits_button_t *button, bits_btn_result_t *result)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+#ifdef BITS_BTN_HAS_READER_NOTIFY
+    uint8_t written = bits_btn_write_buffer_policy_c11(&button->ring_buffer, result);
+    if (written)
+        bits_btn_notify_readers(button);
+    return written;
+#else
+    return bits_btn_write_buffer_policy_c11(&button->ring_buffer, result);
+#endif
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->write)
+    {
+        return bits_btn_buffer_ops->write(result);
+    }
+    return false;
+#endif
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+// btn_tick belongs to the tick; threads reading the buffer use the copy it publishes
+
+static inline void timestamp_publish_tick(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    atomic_store_explicit(&button->ts_published_tick, button->btn_tick, memory_order_relaxed);
+#else
+    button->ts_published_tick = button->btn_tick;
+#endif
+}
+
+static inline uint32_t timestamp_published_tick(bits_button_t *button)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return (uint32_t)atomic_load_explicit(&button->ts_published_tick, memory_order_relaxed);
+#else
+    return button->ts_published_tick;
+#endif
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_STATS
+// ============================================================================
+// Statistics
+// ============================================================================
+// Every counter has a single writer (the tick or the reader), and in the C11
+// buffer mode it is bumped with a relaxed atomic add, so a resetting snapshot
+// from a telemetry thread can swap it to zero without losing an event. In the
+// other buffer modes the counters are plain and a resetting snapshot must not
+// race the tick.
+
+static inline void stats_add(bits_btn_stat_counter_t *counter)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+#else
+    (*counter)++;
+#endif
+}
+
+static inline size_t stats_take(bits_btn_stat_counter_t *counter, uint8_t reset)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    if (reset)
+        return atomic_exchange_explicit(counter, 0, memory_order_relaxed);
+    return atomic_load_explicit(counter, memory_order_relaxed);
+#else
+    size_t value = *counter;
+    if (reset)
+        *counter = 0;
+    return value;
+#endif
+}
+
+/**
+  * @brief  Raise a high watermark to value if it is below.
+  * @param  counter: Watermark counter.
+  * @param  value: Observed value.
+  * @retval None
+  */
+static inline void stats_raise(bits_btn_stat_counter_t *counter, size_t value)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    size_t seen = atomic_load_explicit(counter, memory_order_relaxed);
+    while (value > seen && !atomic_compare_exchange_weak_explicit(counter, &seen, value,
+                                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+#else
+    if (value > *counter)
+        *counter = value;
+#endif
+}
+
+/**
+  * @brief  Map a latency to its log2 histogram bucket.
+  * @param  ticks: Latency in ticks.
+  * @retval 0 for 0 ticks, else the bit length of ticks, capped at the last bucket.
+  */
+static inline uint8_t stats_bucket(uint32_t ticks)
+{
+    uint8_t bucket = 0;
+
+    while (ticks && bucket < BITS_BTN_STATS_BUCKETS - 1)
+    {
+        bucket++;
+        ticks >>= 1;
+    }
+    return bucket;
+}
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+/**
+  * @brief  Account for results held back by BITS_BTN_OVERFLOW_COALESCE that have
+  *         since moved into the ring, and the occupancy they left.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void stats_note_held_published(bits_button_t *button)
+{
+    if (button->ring_buffer.held_published == 0)
+        return;
+
+    do
+    {
+        stats_add(&button->stats.buffered);
+    } while (--button->ring_buffer.held_published);
+    stats_raise(&button->stats.occupancy_high_watermark, get_bits_btn_buffer_used_count_ctx(button));
+}
+#endif
+
+/**
+  * @brief  Account for a reported event and, if it went to the buffer, the occupancy it left.
+  * @param  button: Pointer to the bits button object.
+  * @param  result: Stamped result.
+  * @param  buffered: 1 if the result was written to the buffer.
+  * @retval None
+  */
+static void stats_note_report(bits_button_t *button, const bits_btn_result_t *result, uint8_t buffered)
+{
+    stats_add(&button->stats.reported);
+    if (result->event < BITS_BTN_STATS_EVENT_TYPES)
+        stats_add(&button->stats.report_latency[result->event][stats_bucket(result->report_tick - result->accept_tick)]);
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+    // A result accepted into the held slot only counts once it is published
+    stats_note_held_published(button);
+    if (button->ring_buffer.held_valid)
+        buffered = 0;
+#endif
+    if (buffered)
+    {
+        stats_add(&button->stats.buffered);
+        stats_raise(&button->stats.occupancy_high_watermark, get_bits_btn_buffer_used_count_ctx(button));
+    }
+}
+
+/**
+  * @brief  Account for results read from the buffer.
+  * @param  button: Pointer to the bits button object.
+  * @param  results: Results read, oldest first.
+  * @param  count: Number of results.
+  * @retval None
+  */
+static void stats_note_dequeue(bits_button_t *button, const bits_btn_result_t *results, size_t count)
+{
+    uint32_t now = timestamp_published_tick(button);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        stats_add(&button->stats.dequeued);
+        stats_add(&button->stats.queue_latency[stats_bucket(now - results[i].report_tick)]);
+    }
+}
+
+/**
+  * @brief  Copy the event pipeline statistics, optionally resetting them.
+  * @param  button: Pointer to the bits button object.
+  * @param  stats: Receives the snapshot, may be NULL.
+  * @param  reset: 1 to zero every counter as it is read.
+  * @retval None
+  */
+void bits_button_get_stats_ctx(bits_button_t *button, bits_btn_stats_t *stats, uint8_t reset)
+{
+    bits_btn_stats_t snapshot;
+
+    snapshot.reported = stats_take(&button->stats.reported, reset);
+    snapshot.buffered = stats_take(&button->stats.buffered, reset);
+    snapshot.dequeued = stats_take(&button->stats.dequeued, reset);
+    snapshot.occupancy_high_watermark = stats_take(&button->stats.occupancy_high_watermark, reset);
+    for (size_t b = 0; b < BITS_BTN_STATS_BUCKETS; b++)
+    {
+        snapshot.queue_latency[b] = stats_take(&button->stats.queue_latency[b], reset);
+        for (size_t e = 0; e < BITS_BTN_STATS_EVENT_TYPES; e++)
+        {
+            snapshot.report_latency[e][b] = stats_take(&button->stats.report_latency[e][b], reset);
+        }
+    }
+
+    if (stats)
+        *stats = snapshot;
+}
+
+void bits_button_get_stats(bits_btn_stats_t *stats, uint8_t reset)
+{
+    bits_button_get_stats_ctx(&bits_btn_entity, stats, reset);
+}
+#endif
+
+/**
+  * @brief  Sort combo buttons during initialization (descending by key count)
+  * @param  button: Pointer to button object
+  * @retval None
+  */
+ static void sort_combo_buttons_in_init(bits_button_t *button)
+ {
+    const uint16_t cnt = button->btns_combo_cnt;  // Get number of combo buttons
+
+    // Skip sorting if no combo buttons or only one
+    if (cnt <= 1)
+    {
+        if (button->debug_printf && cnt == 0) button->debug_printf("No combo buttons\n");
+        return;
+    }
+
+    // Initialize index array (0,1,2,...)
+    for (uint16_t i = 0; i < cnt; i++)
+        button->combo_sorted_indices[i] = i;
+
+    // Insertion sort (descending by key count)
+    for (uint16_t i = 1; i < cnt; i++)
+    {
+        const uint16_t temp_idx = button->combo_sorted_indices[i];  // Current element to insert
+        const uint8_t temp_keys = button->btns_combo[temp_idx].key_count;  // Key count of current element
+        int16_t j = i - 1;  // Start from end of sorted portion
+
+        // Find insertion position: higher key count has higher priority
+        while (j >= 0 &&
+               button->btns_combo[button->combo_sorted_indices[j]].key_count < temp_keys)
+        {
+            // Shift lower priority elements backward
+            button->combo_sorted_indices[j + 1] = button->combo_sorted_indices[j];
+            j--;
+        }
+        // Insert current element at correct position
+        button->combo_sorted_indices[j + 1] = temp_idx;
+    }
+
+#if 0
+    // Debug output of sorting results
+    if (button->debug_printf)
+    {
+        button->debug_printf("Sorted combo indices (%d):\n", cnt);
+        for (uint16_t i = 0; i < cnt; i++)
+        {
+            const button_obj_combo_t* c = &button->btns_combo[button->combo_sorted_indices[i]];
+            button->debug_printf("  %d: ID=%d, Keys=", i, c->btn.key_id);
+            for (uint8_t j = 0; j < c->key_count; j++)
+                button->debug_printf("%d ", c->key_single_ids[j]);
+            button->debug_printf("\n");
+        }
+    }
+#endif
+}
+
+/**
+  * @brief  Build the combo index: every combo is listed, by priority rank, under
+  *         its lowest single button. A combo can only be pressed while that key is,
+  *         so the pressed keys' lists plus the busy set cover every combo a tick can advance.
+  * @param  button: Pointer to button object
+  * @retval None
+  */
+static void build_combo_index(bits_button_t *button)
+{
+    memset(button->combo_anchor_sets, 0, sizeof(button->combo_anchor_sets));
+    memset(button->combo_busy_set, 0, sizeof(button->combo_busy_set));
+
+    for (uint16_t r = 0; r < button->btns_combo_cnt; r++)
+    {
+        const bits_btn_mask_t *combo_mask = &button->btns_combo[button->combo_sorted_indices[r]].combo_mask;
+
+        for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+        {
+            button_mask_type_t bits = btn_mask_word(combo_mask, w);
+
+            if (bits)
+            {
+                size_t anchor = w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits);
+                button->combo_anchor_sets[anchor][r / BITS_BTN_MASK_WORD_BITS] |= (button_mask_type_t)1UL << (r % BITS_BTN_MASK_WORD_BITS);
+                break;
+            }
+        }
+    }
+}
+
+/**
+  * @brief  Collect the combos that can act on this tick: the ones anchored at a
+  *         pressed key and the busy ones. Bits not set belong to idle, released combos.
+  * @param  button: Pointer to button object
+  * @param  set: Combo set to fill, bit r stands for combo_sorted_indices[r].
+  * @retval None
+  */
+static void combo_candidates(const bits_button_t *button, button_mask_type_t set[BITS_BTN_COMBO_SET_WORDS])
+{
+    memcpy(set, button->combo_busy_set, sizeof(button->combo_busy_set));
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+    {
+        button_mask_type_t bits = btn_mask_word(&button->current_mask, w);
+
+        while (bits)
+        {
+            const button_mask_type_t *anchored = button->combo_anchor_sets[w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits)];
+
+            bits &= bits - 1;
+            for (size_t c = 0; c < BITS_BTN_COMBO_SET_WORDS; c++)
+                set[c] |= anchored[c];
+        }
+    }
+}
+
+/**
+  * @brief  Check that storage not yet initialized is zero-filled. Only a result
+  *         filter registered before the first init may be set.
+  * @param  button: Pointer to the bits button object.
+  * @retval true if init may take the storage over.
+  */
+static uint8_t bits_btn_storage_is_blank(const bits_button_t *button)
+{
+    const uint8_t *bytes = (const uint8_t *)button;
+
+    for (size_t i = 0; i < sizeof(bits_button_t); i++)
+    {
+#ifndef BITS_BTN_DISABLE_BUFFER
+        if (i >= offsetof(bits_button_t, result_user_filter_cb)
+            && i < offsetof(bits_button_t, result_user_filter_cb) + sizeof(button->result_user_filter_cb))
+            continue;
+#endif
+        if (bytes[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+int32_t bits_button_init_ctx(bits_button_t *button, const bits_btn_config_t *config)
+{
+    if (button == NULL || config == NULL)
+    {
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+
+    bits_btn_debug_printf_func debug_printf = config->bits_btn_debug_printf;
+
+    if ((config->btns == NULL)
+    || (config->btns_cnt == 0)
+    || (config->read_button_level_func == NULL && config->read_button_mask_func == NULL)
+    || (config->btns_combo_cnt > 0 && config->btns_combo == NULL)
+    || (config->pattern_sets_cnt > 0 && config->pattern_sets == NULL)
+    || (config->handlers_cnt > 0 && config->handlers == NULL)
+    || (config->buffer_storage_size > 0 && config->buffer_storage == NULL)
+    || (config->buffer_storage != NULL && config->buffer_storage_size < 2)
+    || (config->buffer_overflow_policy > BITS_BTN_OVERFLOW_COALESCE)
+    || (config->debounce_mode > BITS_BTN_DEBOUNCE_VERTICAL)
+    || (config->engine > BITS_BTN_ENGINE_WHEEL))
+    {
+        if(debug_printf)
+            debug_printf("Invalid init parameters !\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+
+#if defined(BITS_BTN_USE_C11_BUFFER) && defined(BITS_BTN_NO_BUILTIN_BUFFER)
+    if (config->buffer_storage == NULL)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_NO_BUILTIN_BUFFER requires buffer_storage\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifdef BITS_BTN_USE_POW2_BUFFER
+    if ((config->buffer_storage_size & (config->buffer_storage_size - 1)) != 0)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_USE_POW2_BUFFER requires a power of two buffer_storage_size\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    if (config->debounce_mode == BITS_BTN_DEBOUNCE_PER_KEY)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_DEBOUNCE_PER_KEY requires BITS_BTN_ENABLE_PER_KEY_DEBOUNCE\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    if (config->debounce_mode == BITS_BTN_DEBOUNCE_VERTICAL)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_DEBOUNCE_VERTICAL requires BITS_BTN_ENABLE_VERTICAL_DEBOUNCE\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_PATTERNS
+    if (config->pattern_sets_cnt > 0)
+    {
+        if(debug_printf)
+            debug_printf("Error: pattern_sets requires BITS_BTN_ENABLE_PATTERNS\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_HANDLERS
+    if (config->handlers_cnt > 0)
+    {
+        if(debug_printf)
+            debug_printf("Error: handlers requires BITS_BTN_ENABLE_HANDLERS\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_TABLE_ENGINE
+    if (config->engine == BITS_BTN_ENGINE_TABLE)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_ENGINE_TABLE requires BITS_BTN_ENABLE_TABLE_ENGINE\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    if (config->engine == BITS_BTN_ENGINE_BITSLICE)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_ENGINE_BITSLICE requires BITS_BTN_ENABLE_BITSLICE_ENGINE\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_SOA_ENGINE
+    if (config->engine == BITS_BTN_ENGINE_SOA)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_ENGINE_SOA requires BITS_BTN_ENABLE_SOA_ENGINE\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+#ifndef BITS_BTN_ENABLE_WHEEL_ENGINE
+    if (config->engine == BITS_BTN_ENGINE_WHEEL)
+    {
+        if(debug_printf)
+            debug_printf("Error: BITS_BTN_ENGINE_WHEEL requires BITS_BTN_ENABLE_WHEEL_ENGINE\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#endif
+
+    if (config->btns_cnt > BITS_BTN_MAX_BUTTONS)
+    {
+        if (debug_printf)
+            debug_printf("Error: Too many buttons (%d > max %d)\n", config->btns_cnt, (int)BITS_BTN_MAX_BUTTONS);
+        return BITS_BTN_ERR_TOO_MANY_BUTTONS;
+    }
+
+    uint8_t reinit = (button->init_magic == BITS_BTN_INSTANCE_MAGIC);
+    if (!reinit && !bits_btn_storage_is_blank(button))
+    {
+        if(debug_printf)
+            debug_printf("Error: Instance storage must be zero-filled before its first init\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+    if (reinit && button->tick_thread_running)
+    {
+        if(debug_printf)
+            debug_printf("Error: Stop the tick thread before initializing again\n");
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
+    // Wait for a stats reader still holding the lock, then release it for the reset
+    if (reinit)
+        tick_thread_destroy_lock(button);
+#endif
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+    // The result filter may be registered before init, keep it across the reset
+    bits_btn_result_user_filter_callback result_user_filter_cb = button->result_user_filter_cb;
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    // The descriptor may already sit in the caller's epoll set, keep it too
+    int event_fd = reinit ? button->event_fd : -1;
+    uint8_t event_fd_open = reinit ? button->event_fd_open : 0;
+#endif
+
+    memset(button, 0, sizeof(bits_button_t));
+    button->init_magic = BITS_BTN_INSTANCE_MAGIC;
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+    pthread_mutex_init(&button->tick_stats_lock, NULL);
+#endif
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+    button->result_user_filter_cb = result_user_filter_cb;
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    button->event_fd = event_fd;
+    button->event_fd_open = event_fd_open;
+#endif
+    button->debug_printf = debug_printf;
+    button->btns = config->btns;
+    button->btns_cnt = config->btns_cnt;
+    button->btns_combo = config->btns_combo;
+    button->btns_combo_cnt = config->btns_combo_cnt;
+    button->_read_button_level = config->read_button_level_func;
+    button->_read_button_mask = config->read_button_mask_func;
+    button->bits_btn_result_cb = config->bits_btn_result_cb;
+    button->debounce_mode = (uint8_t)config->debounce_mode;
+    button->engine = (uint8_t)config->engine;
+
+    // Precompute the masks used by the batch read path
+    for (uint16_t i = 0; i < config->btns_cnt; i++)
+    {
+        btn_mask_set_bit(&button->btns_valid_mask, i);
+        if (config->btns[i].active_level == 0)
+        {
+            btn_mask_set_bit(&button->active_level_xor_mask, i);
+        }
+    }
+
+    if (config->btns_combo_cnt > BITS_BTN_MAX_COMBO_BUTTONS)
+    {
+        if (debug_printf)
+        {
+            debug_printf("Error: Too many combo buttons (%d > max %d)\n",
+                         config->btns_combo_cnt, BITS_BTN_MAX_COMBO_BUTTONS);
+        }
+        return BITS_BTN_ERR_TOO_MANY_COMBOS;
+    }
+
+    // Check single button param pointers
+    for (uint16_t i = 0; i < config->btns_cnt; i++)
+    {
+        if (config->btns[i].param == NULL)
+        {
+            if (debug_printf)
+                debug_printf("Error: Button[%d] param is NULL\n", i);
+            return BITS_BTN_ERR_BTN_PARAM_NULL;
+        }
+    }
+
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    // The bit-sliced engine compares all single buttons against one set of thresholds
+    if (config->engine == BITS_BTN_ENGINE_BITSLICE)
+    {
+        for (uint16_t i = 1; i < config->btns_cnt; i++)
+        {
+            if (config->btns[i].param != config->btns[0].param
+            && memcmp(config->btns[i].param, config->btns[0].param, sizeof(bits_btn_obj_param_t)) != 0)
+            {
+                if (debug_printf)
+                    debug_printf("Error: Button[%d] param differs from button[0], required by the bit-sliced engine\n", i);
+                return BITS_BTN_ERR_PARAM_MISMATCH;
+            }
+        }
+    }
+#endif
+
+    // Check combo button param pointers
+    for (uint16_t i = 0; i < config->btns_combo_cnt; i++)
+    {
+        if (config->btns_combo[i].btn.param == NULL)
+        {
+            if (debug_printf)
+                debug_printf("Error: Combo button[%d] param is NULL\n", i);
+            return BITS_BTN_ERR_COMBO_PARAM_NULL;
+        }
+    }
+
+    // Check combo button keys configuration validity
+    for (uint16_t i = 0; i < config->btns_combo_cnt; i++)
+    {
+        if (config->btns_combo[i].key_single_ids == NULL ||
+            config->btns_combo[i].key_count == 0)
+        {
+            if (debug_printf)
+                debug_printf("Error: Combo button[%d] has invalid keys config (key_single_ids=%p, key_count=%d)\n",
+                             i,
+                             (void*)config->btns_combo[i].key_single_ids,
+                             config->btns_combo[i].key_count);
+            return BITS_BTN_ERR_COMBO_KEYS_INVALID;
+        }
+    }
+
+#ifdef BITS_BTN_ENABLE_KEY_MAP
+    build_key_index_map(button);
+#endif
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+    build_tick_params(button);
+#endif
+
+#ifdef BITS_BTN_ENABLE_PATTERNS
+    int32_t pattern_ret = build_pattern_tries(button, config);
+    if (pattern_ret != BITS_BTN_OK)
+    {
+        if (debug_printf)
+            debug_printf("Error: Invalid pattern sets (%d)\n", (int)pattern_ret);
+        return pattern_ret;
+    }
+#endif
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+    int32_t handler_ret = build_handler_map(button, config);
+    if (handler_ret != BITS_BTN_OK)
+    {
+        if (debug_printf)
+            debug_printf("Error: Invalid handlers (%d)\n", (int)handler_ret);
+        return handler_ret;
+    }
+#endif
+
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_BITSLICE)
+        bitslice_load(button);
+#endif
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_SOA)
+    {
+        button->soa_kernel = soa_select_kernel();
+        soa_load(button);
+    }
+#endif
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_WHEEL)
+        wheel_load(button);
+#endif
+
+    for(uint16_t i = 0; i < config->btns_combo_cnt; i++)
+    {
+        button_obj_combo_t *combo = &button->btns_combo[i];
+        btn_mask_clear(&combo->combo_mask);
+
+        for(uint16_t j = 0; j < combo->key_count; j++)
+        {
+            int idx = _get_btn_index_by_key_id(button, combo->key_single_ids[j]);
+            if (idx == -1 || idx >= button->btns_cnt)
+            {
+                if(debug_printf)
+                    debug_printf("Error, get_btn_index failed! \n");
+                return BITS_BTN_ERR_INVALID_COMBO_ID;
+            }
+            btn_mask_set_bit(&combo->combo_mask, idx);
+        }
+    }
+
+    // Sort the combination buttons during initialization.
+    sort_combo_buttons_in_init(button);
+    build_combo_index(button);
+
+#ifdef BITS_BTN_USE_USER_BUFFER
+    if (bits_btn_buffer_ops == NULL)
+    {
+        if (debug_printf) debug_printf("Error: External buffer mode requires setting buffer ops!\n");
+        return BITS_BTN_ERR_BUFFER_OPS_NULL;
+    }
+#endif
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+    bits_btn_init_buffer_c11(&button->ring_buffer, config->buffer_storage, config->buffer_storage_size,
+                             (uint8_t)config->buffer_overflow_policy);
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    bits_btn_event_fd_rearm(button);
+#endif
+#else
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->init)
+    {
+        bits_btn_buffer_ops->init();
+    }
+#endif
+
+    return BITS_BTN_OK;
+}
+
+int32_t bits_button_init(const bits_btn_config_t *config)
+{
+    return bits_button_init_ctx(&bits_btn_entity, config);
+}
+
+/**
+  * @brief  Release what an instance holds and zero-fill it.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+void bits_button_deinit_ctx(bits_button_t *button)
+{
+    if (button == NULL || button->init_magic != BITS_BTN_INSTANCE_MAGIC)
+        return;
+
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+    bits_button_stop_tick_thread_ctx(button);
+    tick_thread_destroy_lock(button);
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    bits_button_close_event_fd_ctx(button);
+#endif
+    memset(button, 0, sizeof(bits_button_t));
+}
+
+void bits_button_deinit(void)
+{
+    bits_button_deinit_ctx(&bits_btn_entity);
+}
+
+/**
+  * @brief  Get the button key result from the buffer.
+  * @param  button: Pointer to the bits button object.
+  * @param  result: Pointer to store the button key result
+  * @retval true if read successfully, false if the buffer is empty.
+  */
+uint8_t bits_button_get_key_result_ctx(bits_button_t *button, bits_btn_result_t *result)
+{
+    uint8_t read = false;
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+    read = bits_btn_read_buffer_c11(&button->ring_buffer, result);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->read)
+    {
+        read = bits_btn_buffer_ops->read(result);
+    }
+#endif
+#ifdef BITS_BTN_ENABLE_STATS
+    if (read)
+        stats_note_dequeue(button, result, 1);
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    if (!read)
+        bits_btn_event_fd_rearm(button);
+#endif
+    return read;
+}
+
+uint8_t bits_button_get_key_result(bits_btn_result_t *result)
+{
+    return bits_button_get_key_result_ctx(&bits_btn_entity, result);
+}
+
+/**
+  * @brief  Get up to max button key results from the buffer in one call.
+  * @param  button: Pointer to the bits button object.
+  * @param  out: Array receiving the results, oldest first.
+  * @param  max: Capacity of out.
+  * @retval Number of results read, 0 if the buffer is empty.
+  */
+size_t bits_button_get_key_results_ctx(bits_button_t *button, bits_btn_result_t *out, size_t max)
+{
+    size_t count = 0;
+
+    if (out == NULL)
+        return 0;
+#ifdef BITS_BTN_USE_C11_BUFFER
+    count = bits_btn_read_batch_buffer_c11(&button->ring_buffer, out, max);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->read_batch)
+    {
+        count = bits_btn_buffer_ops->read_batch(out, max);
+    }
+    else
+    {
+        // Buffer ops without a batch read fall back to one read per result
+        while (count < max && bits_btn_buffer_ops && bits_btn_buffer_ops->read && bits_btn_buffer_ops->read(&out[count]))
+        {
+            count++;
+        }
+    }
+#endif
+#ifdef BITS_BTN_ENABLE_STATS
+    stats_note_dequeue(button, out, count);
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    // A short batch found the ring empty
+    if (count < max)
+        bits_btn_event_fd_rearm(button);
+#endif
+    return count;
+}
+
+size_t bits_button_get_key_results(bits_btn_result_t *out, size_t max)
+{
+    return bits_button_get_key_results_ctx(&bits_btn_entity, out, max);
+}
+
+#ifdef BITS_BTN_ENABLE_WAIT
+/**
+  * @brief  Get the button key result from the buffer, blocking while it is empty.
+  * @param  button: Pointer to the bits button object.
+  * @param  result: Pointer to store the button key result
+  * @param  timeout_ms: Longest time to wait, 0 to only try, or BITS_BTN_WAIT_FOREVER.
+  * @retval true if a result was read, false if the timeout expired first.
+  */
+uint8_t bits_button_wait_key_result_ctx(bits_button_t *button, bits_btn_result_t *result, uint32_t timeout_ms)
+{
+    struct timespec deadline;
+    uint8_t read = bits_button_get_key_result_ctx(button, result);
+
+    if (read || timeout_ms == 0)
+        return read;
+
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline, so signals
+    // and wake-ups that lose the result to another reader do not stretch the timeout
+    if (timeout_ms != BITS_BTN_WAIT_FOREVER)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000U;
+        deadline.tv_nsec += (long)(timeout_ms % 1000U) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    atomic_fetch_add_explicit(&button->wait_parked, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    for (;;)
+    {
+        unsigned int seq = atomic_load_explicit(&button->wait_seq, memory_order_acquire);
+
+        read = bits_button_get_key_result_ctx(button, result);
+        if (read)
+            break;
+
+        if (syscall(SYS_futex, &button->wait_seq, FUTEX_WAIT_BITSET_PRIVATE, seq,
+                    timeout_ms == BITS_BTN_WAIT_FOREVER ? NULL : &deadline, NULL, FUTEX_BITSET_MATCH_ANY) != 0
+            && errno == ETIMEDOUT)
+        {
+            read = bits_button_get_key_result_ctx(button, result);
+            break;
+        }
+    }
+
+    atomic_fetch_sub_explicit(&button->wait_parked, 1, memory_order_relaxed);
+    return read;
+}
+
+uint8_t bits_button_wait_key_result(bits_btn_result_t *result, uint32_t timeout_ms)
+{
+    return bits_button_wait_key_result_ctx(&bits_btn_entity, result, timeout_ms);
+}
+#endif
+
+#if defined(BITS_BTN_ENABLE_EVENT_TIMESTAMPS) && !defined(BITS_BTN_DISABLE_BUFFER)
+/**
+  * @brief  Get how long the oldest unread result has been waiting in the buffer.
+  * @param  button: Pointer to the bits button object.
+  * @retval Ticks since the oldest buffered result was reported, 0 if the buffer is empty.
+  */
+uint32_t bits_button_get_queue_age_ctx(bits_button_t *button)
+{
+    bits_btn_result_t oldest;
+
+    if (!bits_button_peek_key_result_ctx(button, &oldest))
+        return 0;
+
+    return timestamp_published_tick(button) - oldest.report_tick;
+}
+
+uint32_t bits_button_get_queue_age(void)
+{
+    return bits_button_get_queue_age_ctx(&bits_btn_entity);
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+/**
+  * @brief  Run the registered handler matching a result.
+  * @param  button: Pointer to the bits button object.
+  * @param  result: Result to dispatch.
+  * @retval 1 if a handler ran, 0 if none matches or result is NULL.
+  */
+uint8_t bits_button_dispatch_result_ctx(bits_button_t *button, const bits_btn_result_t *result)
+{
+    if (result == NULL || button->handlers == NULL)
+        return 0;
+
+    const bits_btn_handler_t *h = handler_find(button, result->key_id, (uint8_t)result->event, result->key_value);
+    if (h == NULL)
+        h = handler_find(button, result->key_id, (uint8_t)result->event, BITS_BTN_ANY_KEY_VALUE);
+    if (h == NULL)
+        return 0;
+
+    h->handler(*result, h->user_data);
+    return 1;
+}
+
+uint8_t bits_button_dispatch_result(const bits_btn_result_t *result)
+{
+    return bits_button_dispatch_result_ctx(&bits_btn_entity, result);
+}
+#endif
+
+/**
+ * @brief  Peek the button key result from the buffer without removing it.
+ * @param  button: Pointer to the bits button object.
+ * @param  result: Pointer to store the button key result
+ * @retval true(1) if peek successfully, false if the buffer is empty.
+ */
+uint8_t bits_button_peek_key_result_ctx(bits_button_t *button, bits_btn_result_t *result)
+{
+#ifdef BITS_BTN_USE_C11_BUFFER
+    return bits_btn_peek_buffer_c11(&button->ring_buffer, result);
+#else
+    (void)button;
+    if (bits_btn_buffer_ops && bits_btn_buffer_ops->peek)
+    {
+        return bits_btn_buffer_ops->peek(result);
+    }
+    return false;
+#endif
+}
+
+uint8_t bits_button_peek_key_result(bits_btn_result_t *result)
+{
+    return bits_button_peek_key_result_ctx(&bits_btn_entity, result);
+}
+
+/**
+  * @brief  Read the physical state of all buttons and build the pressed mask.
+  *         Uses the batch read_button_mask callback when available, otherwise
+  *         falls back to one read_button_level call per button.
+  * @param  button: Pointer to the bits button object.
+  * @retval Mask with bit i set when btns[i] is at its active level.
+  */
+static bits_btn_mask_t read_pressed_mask(bits_button_t *button)
+{
+    if (button->_read_button_mask)
+    {
+        return btn_mask_and(btn_mask_xor(button->_read_button_mask(), button->active_level_xor_mask),
+                            button->btns_valid_mask);
+    }
+
+    bits_btn_mask_t pressed_mask;
+    btn_mask_clear(&pressed_mask);
+    for (size_t i = 0; i < button->btns_cnt; i++)
+    {
+        uint8_t read_gpio_level = button->_read_button_level(&button->btns[i]);
+        if (read_gpio_level == button->btns[i].active_level)
+        {
+            btn_mask_set_bit(&pressed_mask, i);
+        }
+    }
+
+    return pressed_mask;
+}
+
+/**
+  * @brief  Reset all button states to idle.
+  *         This function should be called when resuming from low power mode
+  *         to clear any residual button states from before the pause.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+void bits_button_reset_states_ctx(bits_button_t *button)
+{
+    if (button->debug_printf)
+        button->debug_printf("Resetting all button states\n");
+
+    bits_btn_state_write_begin(button);
 
     // Reset all individual buttons
     for (size_t i = 0; i < button->btns_cnt; i++)
     {
-        button->btns[i].current_state = BTN_STATE_IDLE;
-        button->btns[i].last_state = BTN_STATE_IDLE;
-        button->btns[i].state_bits = 0;
-        button->btns[i].state_entry_time = 0;
-        button->btns[i].long_press_period_trigger_cnt = 0;
+        button->btns[i].current_state = BTN_STATE_IDLE;
+        button->btns[i].last_state = BTN_STATE_IDLE;
+        button->btns[i].state_bits = 0;
+        button->btns[i].state_entry_time = 0;
+        button->btns[i].long_press_period_trigger_cnt = 0;
+    }
+
+    // Reset all combo buttons
+    if (button->btns_combo != NULL && button->btns_combo_cnt > 0)
+    {
+        for (size_t i = 0; i < button->btns_combo_cnt; i++)
+        {
+            button_obj_combo_t *combo = &button->btns_combo[i];
+            combo->btn.current_state = BTN_STATE_IDLE;
+            combo->btn.last_state = BTN_STATE_IDLE;
+            combo->btn.state_bits = 0;
+            combo->btn.state_entry_time = 0;
+            combo->btn.long_press_period_trigger_cnt = 0;
+        }
+    }
+    memset(button->combo_busy_set, 0, sizeof(button->combo_busy_set));
+
+    // Reset global button state and force mask synchronization
+    // This prevents spurious release events after reset
+    bits_btn_mask_t current_physical_mask = read_pressed_mask(button);
+
+    button->current_mask = current_physical_mask;
+    button->last_mask = current_physical_mask;
+    btn_mask_clear(&button->non_idle_mask);
+    button->state_entry_time = get_button_tick(button);
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    memset(button->debounce_cnt, 0, sizeof(button->debounce_cnt));
+#endif
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    memset(button->debounce_planes, 0, sizeof(button->debounce_planes));
+#endif
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_BITSLICE)
+        bitslice_load(button);
+#endif
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_SOA)
+        soa_load(button);
+#endif
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_WHEEL)
+        wheel_load(button);
+#endif
+
+    bits_btn_state_write_end(button);
+
+    // Clear the event buffer
+    bits_btn_clear_buffer_ctx(button);
+}
+
+void bits_button_reset_states(void)
+{
+    bits_button_reset_states_ctx(&bits_btn_entity);
+}
+
+/**
+  * @brief  Add a bit to the end of the number
+  * @param  state_bits: src number point.
+  * @param  bit: tartget bit
+  * @retval none.
+  */
+static void __append_bit(state_bits_type_t* state_bits, uint8_t bit)
+{
+    *state_bits = (*state_bits << 1) | bit;
+}
+
+/**
+  * @brief  check number if match the target bits
+  * @param  state_bits: src number point.
+  * @param  target: tartget bits
+  * @param  target_bits_number: target bits number
+  * @retval 1 if it matches, 0 otherwise.
+  */
+static uint8_t __check_if_the_bits_match(const key_value_type_t *state_bits, key_value_type_t target, uint8_t target_bits_number)
+{
+    key_value_type_t mask = (1 << target_bits_number) - 1;
+
+    return (((*state_bits) & mask) == target? 1 : 0);
+}
+
+#if 0
+uint8_t check_is_repeat_click_mode(struct button_obj_t* button)
+{
+    key_value_type_t kv_input = button->key_value;
+
+    /* Check if the two least significant bits form 0b10 */
+    if((kv_input & 0b11) != 0b10)
+        return 0;
+
+    /* Calculate the XOR result */
+    key_value_type_t xor_result = kv_input ^ (kv_input >> 1);
+
+    /* Check if xor_result + 1 is a power of 2
+       This means all bits except the least significant one are 1 */
+    return (xor_result != 0) && (((xor_result + 1) & (xor_result - 1)) == 0);
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+// ============================================================================
+// Event Timestamps
+// ============================================================================
+// A raw edge is stamped on the first tick the sampled level of a key differs
+// from the level its state machine last ran on; bouncing back cancels it. The
+// acceptance stamp is the tick the state machine first runs on the new level,
+// whatever the debounce mode.
+
+/**
+  * @brief  Stamp the keys whose raw level starts to differ on this tick.
+  * @param  button: Pointer to the bits button object.
+  * @param  raw_mask: Pressed mask sampled on this tick.
+  * @retval None
+  */
+static void timestamp_raw_edges(bits_button_t *button, const bits_btn_mask_t *raw_mask)
+{
+    bits_btn_mask_t pending = btn_mask_xor(*raw_mask, button->ts_seen_mask);
+    bits_btn_mask_t started = btn_mask_andnot(pending, button->ts_edge_pending);
+
+    button->ts_edge_pending = pending;
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+    {
+        button_mask_type_t bits = btn_mask_word(&started, w);
+
+        while (bits)
+        {
+            button->ts_edge_tick[w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits)] = button->btn_tick;
+            bits &= bits - 1;
+        }
+    }
+}
+
+/**
+  * @brief  Stamp the keys whose debounced level the state machines see for the first time.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void timestamp_accepted_edges(bits_button_t *button)
+{
+    bits_btn_mask_t accepted = btn_mask_xor(button->current_mask, button->ts_seen_mask);
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+    {
+        button_mask_type_t bits = btn_mask_word(&accepted, w);
+
+        while (bits)
+        {
+            button->ts_accept_tick[w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits)] = button->btn_tick;
+            bits &= bits - 1;
+        }
+    }
+
+    button->ts_seen_mask = button->current_mask;
+    button->ts_edge_pending = btn_mask_andnot(button->ts_edge_pending, accepted);
+}
+
+/**
+  * @brief  Fill in the timestamps of a result from the edges of its key.
+  *         A combo takes the most recently accepted edge among its keys,
+  *         the later raw edge winning a tie.
+  * @param  button: Pointer to the bits button object.
+  * @param  btn: Button that generated the result.
+  * @param  result: Result to stamp.
+  * @retval None
+  */
+static void timestamp_result(bits_button_t *button, struct button_obj_t *btn, bits_btn_result_t *result)
+{
+    result->report_tick = button->btn_tick;
+    result->edge_tick = button->btn_tick;
+    result->accept_tick = button->btn_tick;
+
+    if (btn >= button->btns && btn < button->btns + button->btns_cnt)
+    {
+        size_t i = (size_t)(btn - button->btns);
+        result->edge_tick = button->ts_edge_tick[i];
+        result->accept_tick = button->ts_accept_tick[i];
+        return;
+    }
+
+    const button_obj_combo_t *combo = (const button_obj_combo_t *)((const char *)btn - offsetof(button_obj_combo_t, btn));
+    uint32_t newest_age = UINT32_MAX;
+
+    for (uint8_t k = 0; k < combo->key_count; k++)
+    {
+        int i = _get_btn_index_by_key_id(button, combo->key_single_ids[k]);
+
+        if (i < 0)
+        {
+            continue;
+        }
+
+        // Keys accepted on the same tick: the one whose raw edge came last completed the combo
+        uint32_t age = button->btn_tick - button->ts_accept_tick[i];
+        if (age < newest_age || (age == newest_age && button->btn_tick - button->ts_edge_tick[i] < button->btn_tick - result->edge_tick))
+        {
+            newest_age = age;
+            result->edge_tick = button->ts_edge_tick[i];
+            result->accept_tick = button->ts_accept_tick[i];
+        }
+    }
+}
+#endif
+
+/**
+  * @brief  Report a button event.
+  * @param  button: Pointer to the bits button object.
+  * @param  btn: Pointer to the button object that generated the event.
+  * @param  result: Pointer to the button result to be reported.
+  * @retval None
+  */
+static void bits_btn_report_event(bits_button_t *button, struct button_obj_t* btn, bits_btn_result_t *result)
+{
+    bits_btn_result_callback btn_result_cb = button->bits_btn_result_cb;
+
+    if(result == NULL) return;
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    timestamp_result(button, btn, result);
+#endif
+
+    if(button->debug_printf)
+        button->debug_printf("key id[%d],event:%d, long trigger_cnt:%d, key_value:", result->key_id, result->event ,result->long_press_period_trigger_cnt);
+    debug_print_binary(button, result->key_value);
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+    uint8_t is_user_result_filter_exist = (button->result_user_filter_cb != NULL);
+    uint8_t default_result_filter_triger = (result->event == BTN_EVENT_LONG_PRESS) || (result->event == BTN_EVENT_FINISH);
+    uint8_t should_write_to_buffer = 0;
+
+    if (is_user_result_filter_exist)
+    {
+        should_write_to_buffer = button->result_user_filter_cb(*result);
+    }
+    else
+    {
+        should_write_to_buffer = default_result_filter_triger;
+    }
+
+    if (should_write_to_buffer)
+    {
+        should_write_to_buffer = bits_btn_write_buffer_ctx(button, result);
+    }
+#endif
+#ifdef BITS_BTN_ENABLE_STATS
+#ifdef BITS_BTN_DISABLE_BUFFER
+    stats_note_report(button, result, 0);
+#else
+    stats_note_report(button, result, should_write_to_buffer);
+#endif
+#endif
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+    uint8_t run_handlers = (button->handlers != NULL && !button->handlers_on_drain);
+#else
+    uint8_t run_handlers = 0;
+#endif
+
+    if(btn_result_cb || run_handlers)
+    {
+        // Let state queries made from the callback see the state as of this event
+        bits_btn_state_write_end(button);
+        if(btn_result_cb)
+            btn_result_cb(btn, *result);
+#ifdef BITS_BTN_ENABLE_HANDLERS
+        if(run_handlers)
+            bits_button_dispatch_result_ctx(button, result);
+#endif
+        bits_btn_state_write_begin(button);
+    }
+}
+
+/**
+  * @brief  Update the button state machine.
+  * @param  button: Pointer to the bits button object.
+  * @param  btn: Pointer to the button object.
+  * @param  index: Index of the button, for its pattern trie.
+  * @param  btn_pressed: Flag indicating whether the button is pressed.
+  * @retval None
+  */
+static void update_button_state_machine(bits_button_t *button, struct button_obj_t* btn,
+                                        size_t index, uint8_t btn_pressed)
+{
+    uint32_t current_time = get_button_tick(button);
+    uint32_t time_diff = current_time - btn->state_entry_time;
+    bits_btn_result_t result = {0};
+    result.key_id = btn->key_id;
+
+    if(btn->param == NULL)
+        return;
+
+    switch (btn->current_state)
+    {
+        case BTN_STATE_IDLE:
+            if (btn_pressed)
+            {
+                __append_bit(&btn->state_bits, 1);
+
+                btn->current_state = BTN_STATE_PRESSED;
+                btn->state_entry_time = current_time;
+                btn->press_start_time = current_time;
+
+                result.key_value = btn->state_bits;
+                result.event = state_to_event((bits_btn_state_t)btn->current_state);
+                bits_btn_report_event(button, btn, &result);
+            }
+            break;
+        case BTN_STATE_PRESSED:
+            if (time_diff * BITS_BTN_TICKS_INTERVAL > btn->param->long_press_start_time_ms)
+            {
+                __append_bit(&btn->state_bits, 1);
+
+                btn->current_state = BTN_STATE_LONG_PRESS;
+                btn->state_entry_time = current_time;
+                btn->long_press_period_trigger_cnt = 0;
+
+                result.key_value = btn->state_bits;
+                result.event = state_to_event((bits_btn_state_t)btn->current_state);
+                bits_btn_report_event(button, btn, &result);
+            }
+            else if (btn_pressed == 0)
+            {
+                btn->current_state = BTN_STATE_RELEASE;
+            }
+            break;
+        case BTN_STATE_LONG_PRESS:
+            if (btn_pressed == 0)
+            {
+                btn->long_press_period_trigger_cnt = 0;
+                btn->current_state = BTN_STATE_RELEASE;
+            }
+            else if(time_diff * BITS_BTN_TICKS_INTERVAL > btn->param->long_press_period_triger_ms)
+            {
+                btn->state_entry_time = current_time;
+                btn->long_press_period_trigger_cnt++;
+
+                if(__check_if_the_bits_match(&btn->state_bits, 0b011, 3))
+                {
+                    __append_bit(&btn->state_bits, 1);
+                }
+
+                result.key_value = btn->state_bits;
+                result.event = state_to_event((bits_btn_state_t)btn->current_state);
+                result.long_press_period_trigger_cnt = btn->long_press_period_trigger_cnt;
+                bits_btn_report_event(button, btn, &result);
+            }
+            break;
+        case BTN_STATE_RELEASE:
+            __append_bit(&btn->state_bits, 0);
+
+            btn->current_state = BTN_STATE_RELEASE_WINDOW;
+            btn->state_entry_time = current_time;
+
+            result.key_value = btn->state_bits;
+            result.event = BTN_EVENT_RELEASE;
+            bits_btn_report_event(button, btn, &result);
+
+            // No registered pattern can follow: skip the time window
+            if (pattern_is_final(button, index, btn->state_bits))
+                btn->current_state = BTN_STATE_FINISH;
+
+            break;
+        case BTN_STATE_RELEASE_WINDOW:
+            if (btn_pressed)
+            {
+                btn->current_state = BTN_STATE_IDLE;
+                btn->state_entry_time = current_time;
+            }
+            else if (time_diff * BITS_BTN_TICKS_INTERVAL > btn->param->time_window_time_ms)
+            {
+                // Time window timeout, trigger event and return to idle
+                btn->current_state = BTN_STATE_FINISH;
+            }
+            break;
+        case BTN_STATE_FINISH:
+
+            result.key_value = btn->state_bits;
+            result.event = BTN_EVENT_FINISH;
+            bits_btn_report_event(button, btn, &result);
+
+            btn->state_bits = 0;
+            btn->current_state = BTN_STATE_IDLE;
+            break;
+        default:
+            break;
+
+    }
+
+    if(btn->last_state != btn->current_state)
+    {
+#if 0
+        if(button->debug_printf)
+            button->debug_printf("id[%d]:cur status:%d,last:%d\n", btn->key_id, btn->current_state, btn->last_state);
+#endif
+        btn->last_state = btn->current_state;
+    }
+}
+
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+// ============================================================================
+// Table-Driven State Machine
+// ============================================================================
+// The same transitions as update_button_state_machine(), with the params
+// precomputed into tick thresholds at init and every (state, pressed, timeout)
+// combination looked up in a table instead of branching on the state.
+
+// Actions of a transition, applied in this order
+#define BTN_ACT_APPEND_1        (1U << 0)   // Append a 1 to state_bits
+#define BTN_ACT_APPEND_0        (1U << 1)   // Append a 0 to state_bits
+#define BTN_ACT_APPEND_HOLD     (1U << 2)   // Append a 1 if state_bits ends in 0b011 (first long press repeat)
+#define BTN_ACT_ENTER           (1U << 3)   // Restart state_entry_time
+#define BTN_ACT_PRESS_START     (1U << 4)   // Record press_start_time
+#define BTN_ACT_LP_RESET        (1U << 5)   // Clear long_press_period_trigger_cnt
+#define BTN_ACT_LP_INC          (1U << 6)   // Count a long press repeat
+#define BTN_ACT_REPORT          (1U << 7)   // Report the transition's event
+#define BTN_ACT_PATTERN_END     (1U << 8)   // Go to FINISH instead if no registered pattern can follow
+#define BTN_ACT_CLEAR_BITS      (1U << 9)   // Clear state_bits once reported
+
+typedef struct
+{
+    uint8_t next_state;
+    uint8_t event;
+    uint16_t actions;
+} btn_transition_t;
+
+// Timeout slot of every state in bits_btn_tick_param_t. States without a
+// timeout use slot 0, the table ignores their timeout column.
+static const uint8_t btn_state_timeout_slot[BTN_STATE_FINISH + 1] = {
+    [BTN_STATE_IDLE]           = 0,
+    [BTN_STATE_PRESSED]        = 1,
+    [BTN_STATE_LONG_PRESS]     = 2,
+    [BTN_STATE_RELEASE]        = 0,
+    [BTN_STATE_RELEASE_WINDOW] = 3,
+    [BTN_STATE_FINISH]         = 0,
+};
+
+#define BTN_TR_STAY(_state)     { _state, 0, 0 }
+
+// Indexed by [state][pressed | timeout << 1]
+static const btn_transition_t btn_transition_table[BTN_STATE_FINISH + 1][4] = {
+    [BTN_STATE_IDLE] = {
+        BTN_TR_STAY(BTN_STATE_IDLE),
+        { BTN_STATE_PRESSED, BTN_EVENT_PRESSED, BTN_ACT_APPEND_1 | BTN_ACT_ENTER | BTN_ACT_PRESS_START | BTN_ACT_REPORT },
+        BTN_TR_STAY(BTN_STATE_IDLE),
+        { BTN_STATE_PRESSED, BTN_EVENT_PRESSED, BTN_ACT_APPEND_1 | BTN_ACT_ENTER | BTN_ACT_PRESS_START | BTN_ACT_REPORT },
+    },
+    [BTN_STATE_PRESSED] = {
+        { BTN_STATE_RELEASE, 0, 0 },
+        BTN_TR_STAY(BTN_STATE_PRESSED),
+        { BTN_STATE_LONG_PRESS, BTN_EVENT_LONG_PRESS, BTN_ACT_APPEND_1 | BTN_ACT_ENTER | BTN_ACT_LP_RESET | BTN_ACT_REPORT },
+        { BTN_STATE_LONG_PRESS, BTN_EVENT_LONG_PRESS, BTN_ACT_APPEND_1 | BTN_ACT_ENTER | BTN_ACT_LP_RESET | BTN_ACT_REPORT },
+    },
+    [BTN_STATE_LONG_PRESS] = {
+        { BTN_STATE_RELEASE, 0, BTN_ACT_LP_RESET },
+        BTN_TR_STAY(BTN_STATE_LONG_PRESS),
+        { BTN_STATE_RELEASE, 0, BTN_ACT_LP_RESET },
+        { BTN_STATE_LONG_PRESS, BTN_EVENT_LONG_PRESS, BTN_ACT_APPEND_HOLD | BTN_ACT_ENTER | BTN_ACT_LP_INC | BTN_ACT_REPORT },
+    },
+    [BTN_STATE_RELEASE] = {
+        { BTN_STATE_RELEASE_WINDOW, BTN_EVENT_RELEASE, BTN_ACT_APPEND_0 | BTN_ACT_ENTER | BTN_ACT_PATTERN_END | BTN_ACT_REPORT },
+        { BTN_STATE_RELEASE_WINDOW, BTN_EVENT_RELEASE, BTN_ACT_APPEND_0 | BTN_ACT_ENTER | BTN_ACT_PATTERN_END | BTN_ACT_REPORT },
+        { BTN_STATE_RELEASE_WINDOW, BTN_EVENT_RELEASE, BTN_ACT_APPEND_0 | BTN_ACT_ENTER | BTN_ACT_PATTERN_END | BTN_ACT_REPORT },
+        { BTN_STATE_RELEASE_WINDOW, BTN_EVENT_RELEASE, BTN_ACT_APPEND_0 | BTN_ACT_ENTER | BTN_ACT_PATTERN_END | BTN_ACT_REPORT },
+    },
+    [BTN_STATE_RELEASE_WINDOW] = {
+        BTN_TR_STAY(BTN_STATE_RELEASE_WINDOW),
+        { BTN_STATE_IDLE, 0, BTN_ACT_ENTER },
+        { BTN_STATE_FINISH, 0, 0 },
+        { BTN_STATE_IDLE, 0, BTN_ACT_ENTER },
+    },
+    [BTN_STATE_FINISH] = {
+        { BTN_STATE_IDLE, BTN_EVENT_FINISH, BTN_ACT_REPORT | BTN_ACT_CLEAR_BITS },
+        { BTN_STATE_IDLE, BTN_EVENT_FINISH, BTN_ACT_REPORT | BTN_ACT_CLEAR_BITS },
+        { BTN_STATE_IDLE, BTN_EVENT_FINISH, BTN_ACT_REPORT | BTN_ACT_CLEAR_BITS },
+        { BTN_STATE_IDLE, BTN_EVENT_FINISH, BTN_ACT_REPORT | BTN_ACT_CLEAR_BITS },
+    },
+};
+
+/**
+  * @brief  Update the button state machine through the transition table.
+  * @param  button: Pointer to the bits button object.
+  * @param  btn: Pointer to the button object.
+  * @param  index: Index of the button, for its precomputed thresholds and pattern trie.
+  * @param  btn_pressed: Flag indicating whether the button is pressed.
+  * @retval None
+  */
+static void update_button_state_table(bits_button_t *button, struct button_obj_t* btn,
+                                      size_t index, uint8_t btn_pressed)
+{
+    const bits_btn_tick_param_t *tick_param = &button->tick_params[index];
+    uint32_t current_time = get_button_tick(button);
+    uint8_t state = btn->current_state;
+    uint8_t timeout = (current_time - btn->state_entry_time) > tick_param->timeout_ticks[btn_state_timeout_slot[state]];
+    const btn_transition_t *tr = &btn_transition_table[state][(btn_pressed != 0) | (timeout << 1)];
+    uint16_t actions = tr->actions;
+    bits_btn_result_t result = {0};
+
+    btn->current_state = tr->next_state;
+    btn->last_state = tr->next_state;
+
+    if (actions == 0)
+        return;
+
+    if (actions & BTN_ACT_APPEND_1)
+        __append_bit(&btn->state_bits, 1);
+    if (actions & BTN_ACT_APPEND_0)
+        __append_bit(&btn->state_bits, 0);
+    if ((actions & BTN_ACT_APPEND_HOLD) && __check_if_the_bits_match(&btn->state_bits, 0b011, 3))
+        __append_bit(&btn->state_bits, 1);
+    if (actions & BTN_ACT_ENTER)
+        btn->state_entry_time = current_time;
+    if (actions & BTN_ACT_PRESS_START)
+        btn->press_start_time = current_time;
+    if (actions & BTN_ACT_LP_RESET)
+        btn->long_press_period_trigger_cnt = 0;
+    if (actions & BTN_ACT_LP_INC)
+        result.long_press_period_trigger_cnt = ++btn->long_press_period_trigger_cnt;
+
+    if (actions & BTN_ACT_REPORT)
+    {
+        result.key_id = btn->key_id;
+        result.key_value = btn->state_bits;
+        result.event = tr->event;
+        bits_btn_report_event(button, btn, &result);
+    }
+
+    // After the report, like the switch engine: the RELEASE callback still sees RELEASE_WINDOW
+    if ((actions & BTN_ACT_PATTERN_END) && pattern_is_final(button, index, btn->state_bits))
+    {
+        btn->current_state = BTN_STATE_FINISH;
+        btn->last_state = BTN_STATE_FINISH;
+    }
+
+    if (actions & BTN_ACT_CLEAR_BITS)
+        btn->state_bits = 0;
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+// ============================================================================
+// Bit-Sliced State Machine
+// ============================================================================
+// Single buttons that share one param keep their state code and the ticks spent
+// in that state as bit-planes (plane b holds bit b of every key), so the keys
+// that transition on a tick are found with a fixed number of mask operations
+// whatever the number of keys. Only those keys then go through the per-key
+// table step, which reports the events and keeps button_obj_t up to date for
+// the state queries and the deadline calculation.
+
+/**
+  * @brief  Rebuild the bit-planes from the single button objects.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void bitslice_load(bits_button_t *button)
+{
+    const bits_btn_tick_param_t *tick_param = &button->tick_params[0];
+    uint32_t now = get_button_tick(button);
+    uint32_t max_threshold = 0;
+    uint32_t age_max;
+
+    // Saturated ages must stay above every threshold
+    for (size_t slot = 1; slot < 4; slot++)
+    {
+        if (tick_param->timeout_ticks[slot] > max_threshold)
+            max_threshold = tick_param->timeout_ticks[slot];
+    }
+    button->slice_age_planes = 1;
+    while (((1UL << button->slice_age_planes) - 1) <= max_threshold)
+        button->slice_age_planes++;
+    age_max = (1UL << button->slice_age_planes) - 1;
+
+    memset(button->slice_state, 0, sizeof(button->slice_state));
+    memset(button->slice_age, 0, sizeof(button->slice_age));
+    button->slice_time = now;
+
+    for (size_t i = 0; i < button->btns_cnt; i++)
+    {
+        const struct button_obj_t *btn = &button->btns[i];
+        uint32_t age = now - btn->state_entry_time;
+
+        if (age > age_max)
+            age = age_max;
+
+        for (size_t b = 0; b < 3; b++)
+        {
+            if ((btn->current_state >> b) & 1U)
+                btn_mask_set_bit(&button->slice_state[b], i);
+        }
+        for (size_t b = 0; b < button->slice_age_planes; b++)
+        {
+            if ((age >> b) & 1U)
+                btn_mask_set_bit(&button->slice_age[b], i);
+        }
+    }
+}
+
+/**
+  * @brief  Add the same number of ticks to every age counter, saturating instead of wrapping.
+  * @param  button: Pointer to the bits button object.
+  * @param  ticks: Ticks since the last bit-sliced step.
+  * @retval None
+  */
+static void bitslice_age_add(bits_button_t *button, uint32_t ticks)
+{
+    bits_btn_mask_t *age = button->slice_age;
+    bits_btn_mask_t carry;
+
+    btn_mask_clear(&carry);
+
+    // Ripple-carry add of the constant, one plane at a time
+    for (size_t b = 0; b < button->slice_age_planes; b++)
+    {
+        bits_btn_mask_t sum = btn_mask_xor(age[b], carry);
+
+        if ((ticks >> b) & 1U)
+        {
+            carry = btn_mask_or(age[b], carry);
+            age[b] = btn_mask_andnot(button->btns_valid_mask, sum);
+        }
+        else
+        {
+            carry = btn_mask_and(age[b], carry);
+            age[b] = sum;
+        }
+    }
+
+    if ((ticks >> button->slice_age_planes) != 0)
+        carry = button->btns_valid_mask;
+
+    for (size_t b = 0; b < button->slice_age_planes; b++)
+        age[b] = btn_mask_or(age[b], carry);
+}
+
+/**
+  * @brief  Find the keys whose age exceeds a threshold.
+  * @param  button: Pointer to the bits button object.
+  * @param  threshold: Threshold in ticks, below 2^slice_age_planes.
+  * @retval Mask of the keys with age > threshold.
+  */
+static bits_btn_mask_t bitslice_age_exceeds(const bits_button_t *button, uint32_t threshold)
+{
+    const bits_btn_mask_t *age = button->slice_age;
+    bits_btn_mask_t greater;
+    bits_btn_mask_t equal = button->btns_valid_mask;
+
+    btn_mask_clear(&greater);
+
+    // Compare from the most significant plane down
+    for (size_t b = button->slice_age_planes; b-- > 0;)
+    {
+        if ((threshold >> b) & 1U)
+        {
+            equal = btn_mask_and(equal, age[b]);
+        }
+        else
+        {
+            greater = btn_mask_or(greater, btn_mask_and(equal, age[b]));
+            equal = btn_mask_andnot(equal, age[b]);
+        }
+    }
+
+    return greater;
+}
+
+/**
+  * @brief  Advance all unsuppressed single buttons with the bit-sliced engine.
+  *         Computes the same transitions as the transition table for every key at
+  *         once, then runs the table step only for the keys that transition.
+  * @param  button: Pointer to the bits button object.
+  * @param  suppression_mask: The suppression mask.
+  * @retval None
+  */
+static void dispatch_bitslice_buttons(bits_button_t *button, const bits_btn_mask_t *suppression_mask)
+{
+    const bits_btn_tick_param_t *tick_param = &button->tick_params[0];
+    bits_btn_mask_t *state = button->slice_state;
+    uint32_t now = get_button_tick(button);
+    bits_btn_mask_t active = btn_mask_andnot(button->btns_valid_mask, *suppression_mask);
+    bits_btn_mask_t pressed = btn_mask_and(active, button->current_mask);
+
+    // All idle and released: nothing to step. The ages catch up (saturated) on
+    // the next step, which only matters for idle keys, whose ages are unused.
+    if (!btn_mask_intersects(&button->non_idle_mask, &button->btns_valid_mask)
+        && !btn_mask_intersects(&pressed, &pressed))
+        return;
+
+    bitslice_age_add(button, now - button->slice_time);
+    button->slice_time = now;
+
+    bits_btn_mask_t released = btn_mask_andnot(active, button->current_mask);
+
+    // Decode the state codes, see bits_btn_state_t
+    bits_btn_mask_t low = btn_mask_andnot(active, state[2]);
+    bits_btn_mask_t high = btn_mask_and(active, state[2]);
+    bits_btn_mask_t in_idle = btn_mask_andnot(btn_mask_andnot(low, state[1]), state[0]);
+    bits_btn_mask_t in_pressed = btn_mask_and(btn_mask_andnot(low, state[1]), state[0]);
+    bits_btn_mask_t in_long_press = btn_mask_andnot(btn_mask_and(low, state[1]), state[0]);
+    bits_btn_mask_t in_release = btn_mask_and(btn_mask_and(low, state[1]), state[0]);
+    bits_btn_mask_t in_window = btn_mask_andnot(high, state[0]);
+    bits_btn_mask_t in_finish = btn_mask_and(high, state[0]);
+
+    bits_btn_mask_t long_press_timeout = bitslice_age_exceeds(button, tick_param->timeout_ticks[1]);
+    bits_btn_mask_t period_timeout = bitslice_age_exceeds(button, tick_param->timeout_ticks[2]);
+    bits_btn_mask_t window_timeout = bitslice_age_exceeds(button, tick_param->timeout_ticks[3]);
+
+    bits_btn_mask_t to_pressed = btn_mask_and(in_idle, pressed);
+    bits_btn_mask_t to_long_press = btn_mask_and(in_pressed, long_press_timeout);
+    bits_btn_mask_t pressed_to_release = btn_mask_andnot(btn_mask_and(in_pressed, released), long_press_timeout);
+    bits_btn_mask_t long_press_to_release = btn_mask_and(in_long_press, released);
+    bits_btn_mask_t long_press_hold = btn_mask_and(btn_mask_and(in_long_press, pressed), period_timeout);
+    bits_btn_mask_t window_to_idle = btn_mask_and(in_window, pressed);
+    bits_btn_mask_t to_finish = btn_mask_and(btn_mask_and(in_window, released), window_timeout);
+
+    bits_btn_mask_t to_release = btn_mask_or(pressed_to_release, long_press_to_release);
+    bits_btn_mask_t changed = btn_mask_or(btn_mask_or(btn_mask_or(to_pressed, to_long_press), btn_mask_or(to_release, in_release)),
+                                          btn_mask_or(btn_mask_or(window_to_idle, to_finish), in_finish));
+    bits_btn_mask_t entered = btn_mask_or(btn_mask_or(btn_mask_or(to_pressed, to_long_press), long_press_hold),
+                                          btn_mask_or(in_release, window_to_idle));
+
+    // New state codes: PRESSED 001, LONG_PRESS 010, RELEASE 011, RELEASE_WINDOW 100, FINISH 101, IDLE 000
+    state[0] = btn_mask_or(btn_mask_andnot(state[0], changed), btn_mask_or(btn_mask_or(to_pressed, to_release), to_finish));
+    state[1] = btn_mask_or(btn_mask_andnot(state[1], changed), btn_mask_or(to_long_press, to_release));
+    state[2] = btn_mask_or(btn_mask_andnot(state[2], changed), btn_mask_or(in_release, to_finish));
+
+    for (size_t b = 0; b < button->slice_age_planes; b++)
+        button->slice_age[b] = btn_mask_andnot(button->slice_age[b], entered);
+
+    button->non_idle_mask = btn_mask_or(btn_mask_or(state[0], state[1]), state[2]);
+
+    // Per-key work only for the keys that transition
+    bits_btn_mask_t work = btn_mask_or(changed, long_press_hold);
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+    {
+        button_mask_type_t bits = btn_mask_word(&work, w);
+
+        while (bits)
+        {
+            size_t i = w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits);
+
+            bits &= bits - 1;
+            update_button_state_table(button, &button->btns[i], i,
+                                      btn_mask_test_bit(&button->current_mask, i));
+
+            // A release that ends every registered pattern skips the window: code 100 becomes 101
+            if (button->btns[i].current_state == BTN_STATE_FINISH && btn_mask_test_bit(&in_release, i))
+                btn_mask_set_bit(&state[0], i);
+        }
+    }
+}
+#endif
+
+#ifdef BITS_BTN_HAS_WAKE_MASKS
+// ============================================================================
+// Wake Masks
+// ============================================================================
+// The state classes that react to the input level. Engines that track timeouts
+// on their own combine these with the current mask to find the keys whose
+// state can change on a tick without a timeout.
+
+/**
+  * @brief  Record which input level ends the current state of one single button.
+  * @param  button: Pointer to the bits button object.
+  * @param  i: Index of the single button.
+  * @retval None
+  */
+static void wake_sync_key(bits_button_t *button, size_t i)
+{
+    const struct button_obj_t *btn = &button->btns[i];
+
+    btn_mask_clear_bit(&button->wake_pressed, i);
+    btn_mask_clear_bit(&button->wake_released, i);
+    btn_mask_clear_bit(&button->wake_always, i);
+
+    switch (btn->current_state)
+    {
+        case BTN_STATE_IDLE:
+        case BTN_STATE_RELEASE_WINDOW:
+            btn_mask_set_bit(&button->wake_pressed, i);
+            break;
+        case BTN_STATE_PRESSED:
+        case BTN_STATE_LONG_PRESS:
+            btn_mask_set_bit(&button->wake_released, i);
+            break;
+        default:
+            btn_mask_set_bit(&button->wake_always, i);
+            break;
+    }
+
+    if (btn->current_state == BTN_STATE_IDLE)
+        btn_mask_clear_bit(&button->non_idle_mask, i);
+    else
+        btn_mask_set_bit(&button->non_idle_mask, i);
+}
+
+/**
+  * @brief  Keys whose input level ends their state on this tick.
+  * @param  button: Pointer to the bits button object.
+  * @param  pressed: Unsuppressed single buttons that are pressed.
+  * @param  released: Unsuppressed single buttons that are released.
+  * @retval Mask of the woken keys.
+  */
+static bits_btn_mask_t wake_keys(const bits_button_t *button, const bits_btn_mask_t *pressed,
+                                 const bits_btn_mask_t *released)
+{
+    return btn_mask_or(button->wake_always,
+                       btn_mask_or(btn_mask_and(*pressed, button->wake_pressed),
+                                   btn_mask_and(*released, button->wake_released)));
+}
+
+/**
+  * @brief  Empty the wake masks before the single buttons are synced again.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void wake_clear(bits_button_t *button)
+{
+    btn_mask_clear(&button->wake_pressed);
+    btn_mask_clear(&button->wake_released);
+    btn_mask_clear(&button->wake_always);
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+// ============================================================================
+// Structure-of-Arrays State Machine
+// ============================================================================
+// The entry tick and the current state's timeout of every single button live
+// in two flat arrays, so "which buttons timed out on this tick" is one pass of
+// vector subtract/compare/movemask over contiguous memory. Together with the
+// wake masks (the state classes that react to the input level) it gives the
+// keys that transition; only those go through the per-key table step.
+
+enum
+{
+    BTN_SOA_KERNEL_SCALAR = 0,
+    BTN_SOA_KERNEL_SSE2,
+    BTN_SOA_KERNEL_AVX2,
+};
+
+/**
+  * @brief  Timeout kernels: set bit i of words for every i < count with now - entry[i] > threshold[i].
+  *         count is a multiple of 8, each 32-key word is written in full.
+  */
+static void soa_timeouts_scalar(const uint32_t *entry, const uint32_t *threshold, size_t count,
+                                uint32_t now, button_mask_type_t *words)
+{
+    for (size_t base = 0; base < count; base += BITS_BTN_MASK_WORD_BITS)
+    {
+        size_t end = (count - base < BITS_BTN_MASK_WORD_BITS) ? count : base + BITS_BTN_MASK_WORD_BITS;
+        button_mask_type_t word = 0;
+
+        for (size_t i = base; i < end; i++)
+            word |= (button_mask_type_t)((now - entry[i]) > threshold[i]) << (i - base);
+
+        words[base / BITS_BTN_MASK_WORD_BITS] = word;
+    }
+}
+
+#ifdef BITS_BTN_SOA_X86
+// SSE has no unsigned compare: flipping the sign bits turns it into a signed one
+__attribute__((target("sse2")))
+static void soa_timeouts_sse2(const uint32_t *entry, const uint32_t *threshold, size_t count,
+                              uint32_t now, button_mask_type_t *words)
+{
+    const __m128i bias = _mm_set1_epi32((int)0x80000000U);
+    const __m128i now_vec = _mm_set1_epi32((int)now);
+
+    for (size_t base = 0; base < count; base += BITS_BTN_MASK_WORD_BITS)
+    {
+        size_t end = (count - base < BITS_BTN_MASK_WORD_BITS) ? count : base + BITS_BTN_MASK_WORD_BITS;
+        button_mask_type_t word = 0;
+
+        for (size_t i = base; i < end; i += 4)
+        {
+            __m128i diff = _mm_sub_epi32(now_vec, _mm_loadu_si128((const __m128i *)&entry[i]));
+            __m128i limit = _mm_loadu_si128((const __m128i *)&threshold[i]);
+            __m128i expired = _mm_cmpgt_epi32(_mm_xor_si128(diff, bias), _mm_xor_si128(limit, bias));
+
+            word |= (button_mask_type_t)_mm_movemask_ps(_mm_castsi128_ps(expired)) << (i - base);
+        }
+
+        words[base / BITS_BTN_MASK_WORD_BITS] = word;
+    }
+}
+
+__attribute__((target("avx2")))
+static void soa_timeouts_avx2(const uint32_t *entry, const uint32_t *threshold, size_t count,
+                              uint32_t now, button_mask_type_t *words)
+{
+    const __m256i bias = _mm256_set1_epi32((int)0x80000000U);
+    const __m256i now_vec = _mm256_set1_epi32((int)now);
+
+    for (size_t base = 0; base < count; base += BITS_BTN_MASK_WORD_BITS)
+    {
+        size_t end = (count - base < BITS_BTN_MASK_WORD_BITS) ? count : base + BITS_BTN_MASK_WORD_BITS;
+        button_mask_type_t word = 0;
+
+        for (size_t i = base; i < end; i += 8)
+        {
+            __m256i diff = _mm256_sub_epi32(now_vec, _mm256_loadu_si256((const __m256i *)&entry[i]));
+            __m256i limit = _mm256_loadu_si256((const __m256i *)&threshold[i]);
+            __m256i expired = _mm256_cmpgt_epi32(_mm256_xor_si256(diff, bias), _mm256_xor_si256(limit, bias));
+
+            word |= (button_mask_type_t)_mm256_movemask_ps(_mm256_castsi256_ps(expired)) << (i - base);
+        }
+
+        words[base / BITS_BTN_MASK_WORD_BITS] = word;
+    }
+}
+#endif
+
+/**
+  * @brief  Pick the widest timeout kernel the CPU supports.
+  * @retval One of BTN_SOA_KERNEL_*.
+  */
+static uint8_t soa_select_kernel(void)
+{
+#ifdef BITS_BTN_SOA_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return BTN_SOA_KERNEL_AVX2;
+    return BTN_SOA_KERNEL_SSE2;
+#else
+    return BTN_SOA_KERNEL_SCALAR;
+#endif
+}
+
+/**
+  * @brief  Copy one single button's timer and state class into the arrays.
+  * @param  button: Pointer to the bits button object.
+  * @param  i: Index of the single button.
+  * @retval None
+  */
+static void soa_sync_key(bits_button_t *button, size_t i)
+{
+    const struct button_obj_t *btn = &button->btns[i];
+    uint8_t slot = btn_state_timeout_slot[btn->current_state];
+
+    button->soa_entry[i] = btn->state_entry_time;
+    button->soa_threshold[i] = slot ? button->tick_params[i].timeout_ticks[slot] : UINT32_MAX;
+    wake_sync_key(button, i);
+}
+
+/**
+  * @brief  Rebuild the arrays from the single button objects. The padding never times out.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void soa_load(bits_button_t *button)
+{
+    for (size_t i = 0; i < BITS_BTN_SOA_SLOTS; i++)
+    {
+        button->soa_entry[i] = 0;
+        button->soa_threshold[i] = UINT32_MAX;
+    }
+    wake_clear(button);
+
+    for (size_t i = 0; i < button->btns_cnt; i++)
+        soa_sync_key(button, i);
+}
+
+/**
+  * @brief  Advance all unsuppressed single buttons with the structure-of-arrays engine.
+  * @param  button: Pointer to the bits button object.
+  * @param  suppression_mask: The suppression mask.
+  * @retval None
+  */
+static void dispatch_soa_buttons(bits_button_t *button, const bits_btn_mask_t *suppression_mask)
+{
+    uint32_t now = get_button_tick(button);
+    size_t count = ((size_t)button->btns_cnt + 7) / 8 * 8;
+    bits_btn_mask_t active = btn_mask_andnot(button->btns_valid_mask, *suppression_mask);
+    bits_btn_mask_t pressed = btn_mask_and(active, button->current_mask);
+    bits_btn_mask_t released = btn_mask_andnot(active, button->current_mask);
+    bits_btn_mask_t expired;
+
+    if (!btn_mask_intersects(&button->non_idle_mask, &button->btns_valid_mask)
+        && !btn_mask_intersects(&pressed, &pressed))
+        return;
+
+    btn_mask_clear(&expired);
+    switch (button->soa_kernel)
+    {
+#ifdef BITS_BTN_SOA_X86
+        case BTN_SOA_KERNEL_AVX2:
+            soa_timeouts_avx2(button->soa_entry, button->soa_threshold, count, now, btn_mask_words(&expired));
+            break;
+        case BTN_SOA_KERNEL_SSE2:
+            soa_timeouts_sse2(button->soa_entry, button->soa_threshold, count, now, btn_mask_words(&expired));
+            break;
+#endif
+        default:
+            soa_timeouts_scalar(button->soa_entry, button->soa_threshold, count, now, btn_mask_words(&expired));
+            break;
+    }
+
+    bits_btn_mask_t work = btn_mask_and(btn_mask_or(expired, wake_keys(button, &pressed, &released)), active);
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+    {
+        button_mask_type_t bits = btn_mask_word(&work, w);
+
+        while (bits)
+        {
+            size_t i = w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits);
+
+            bits &= bits - 1;
+            update_button_state_table(button, &button->btns[i], i,
+                                      btn_mask_test_bit(&button->current_mask, i));
+            soa_sync_key(button, i);
+        }
+    }
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+// ============================================================================
+// Timer Wheel State Machine
+// ============================================================================
+// Entering the pressed, long press or release window state schedules the tick
+// on which that state times out in a hierarchical timer wheel keyed by absolute
+// tick. Level l holds the timers whose deadline first differs from the wheel's
+// time in digit l (BITS_BTN_WHEEL_SLOT_BITS bits per digit), in the slot of that
+// digit. When the time reaches the start of a slot's range the slot is cascaded
+// into the lower levels, level 0 slots fire. A tick then only steps the keys whose
+// timer fired or whose input level ends their state; idle buttons cost nothing.
+
+#define BTN_WHEEL_NONE          0xFFFFU     // End of a slot list
+#define BTN_WHEEL_UNLINKED      0xFFU       // Key without a scheduled timer
+
+/**
+  * @brief  Link the timer of one single button into the slot of its deadline.
+  * @param  button: Pointer to the bits button object.
+  * @param  i: Index of the single button, its wheel_deadline must be at or after now.
+  * @param  now: Tick the slot is chosen relative to.
+  * @retval None
+  */
+static void wheel_insert(bits_button_t *button, uint16_t i, uint32_t now)
+{
+    uint32_t deadline = button->wheel_deadline[i];
+    uint32_t diff = deadline ^ now;
+    uint8_t level = 0;
+
+    while (level + 1 < BITS_BTN_WHEEL_LEVELS && (diff >> ((level + 1) * BITS_BTN_WHEEL_SLOT_BITS)) != 0)
+        level++;
+
+    uint8_t slot = (uint8_t)(level * BITS_BTN_WHEEL_SLOTS
+                             + ((deadline >> (level * BITS_BTN_WHEEL_SLOT_BITS)) & (BITS_BTN_WHEEL_SLOTS - 1)));
+    uint16_t head = button->wheel_head[slot];
+
+    button->wheel_slot[i] = slot;
+    button->wheel_prev[i] = BTN_WHEEL_NONE;
+    button->wheel_next[i] = head;
+    if (head != BTN_WHEEL_NONE)
+        button->wheel_prev[head] = i;
+    button->wheel_head[slot] = i;
+    button->wheel_count++;
+}
+
+/**
+  * @brief  Remove the scheduled timer of one single button.
+  * @param  button: Pointer to the bits button object.
+  * @param  i: Index of the single button.
+  * @retval None
+  */
+static void wheel_unlink(bits_button_t *button, uint16_t i)
+{
+    uint16_t prev = button->wheel_prev[i];
+    uint16_t next = button->wheel_next[i];
+
+    if (prev == BTN_WHEEL_NONE)
+        button->wheel_head[button->wheel_slot[i]] = next;
+    else
+        button->wheel_next[prev] = next;
+    if (next != BTN_WHEEL_NONE)
+        button->wheel_prev[next] = prev;
+
+    button->wheel_slot[i] = BTN_WHEEL_UNLINKED;
+    button->wheel_count--;
+}
+
+/**
+  * @brief  Move the wheel forward to now, cascading the slots whose range starts
+  *         on each tick and marking the keys of the fired level 0 slots as expired.
+  * @param  button: Pointer to the bits button object.
+  * @param  now: Current tick.
+  * @retval None
+  */
+static void wheel_advance(bits_button_t *button, uint32_t now)
+{
+    while (button->wheel_count != 0 && button->wheel_time != now)
+    {
+        uint32_t t = ++button->wheel_time;
+        uint16_t i;
+
+        // Top level first: a timer cascaded on tick t never lands in a slot cascaded later on t
+        for (uint8_t level = BITS_BTN_WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            if ((t & ((1UL << (level * BITS_BTN_WHEEL_SLOT_BITS)) - 1)) != 0)
+                continue;
+
+            uint8_t slot = (uint8_t)(level * BITS_BTN_WHEEL_SLOTS
+                                     + ((t >> (level * BITS_BTN_WHEEL_SLOT_BITS)) & (BITS_BTN_WHEEL_SLOTS - 1)));
+
+            while ((i = button->wheel_head[slot]) != BTN_WHEEL_NONE)
+            {
+                wheel_unlink(button, i);
+                wheel_insert(button, i, t);
+            }
+        }
+
+        while ((i = button->wheel_head[t & (BITS_BTN_WHEEL_SLOTS - 1)]) != BTN_WHEEL_NONE)
+        {
+            wheel_unlink(button, i);
+            btn_mask_set_bit(&button->wheel_expired, i);
+        }
     }
 
-    // Reset all combo buttons
-    if (button->btns_combo != NULL && button->btns_combo_cnt > 0)
+    button->wheel_time = now;
+}
+
+/**
+  * @brief  Reschedule the timer and the state class of one single button after its step.
+  * @param  button: Pointer to the bits button object.
+  * @param  i: Index of the single button.
+  * @retval None
+  */
+static void wheel_sync_key(bits_button_t *button, uint16_t i)
+{
+    const struct button_obj_t *btn = &button->btns[i];
+    uint8_t slot = btn_state_timeout_slot[btn->current_state];
+
+    if (button->wheel_slot[i] != BTN_WHEEL_UNLINKED)
+        wheel_unlink(button, i);
+    btn_mask_clear_bit(&button->wheel_expired, i);
+
+    if (slot)
     {
-        for (size_t i = 0; i < button->btns_combo_cnt; i++)
+        // Times out once the ticks spent in the state exceed the threshold
+        uint32_t deadline = btn->state_entry_time + button->tick_params[i].timeout_ticks[slot] + 1;
+
+        if ((int32_t)(deadline - button->wheel_time) <= 0)
         {
-            button_obj_combo_t *combo = &button->btns_combo[i];
-            combo->btn.current_state = BTN_STATE_IDLE;
-            combo->btn.last_state = BTN_STATE_IDLE;
-            combo->btn.state_bits = 0;
-            combo->btn.state_entry_time = 0;
-            combo->btn.long_press_period_trigger_cnt = 0;
+            btn_mask_set_bit(&button->wheel_expired, i);
+        }
+        else
+        {
+            button->wheel_deadline[i] = deadline;
+            wheel_insert(button, i, button->wheel_time);
         }
     }
 
-    // Reset global button state and force mask synchronization
-    // This prevents spurious release events after reset
-    button_mask_type_t current_physical_mask = 0;
-    for(size_t i = 0; i < button->btns_cnt; i++)
+    wake_sync_key(button, i);
+}
+
+/**
+  * @brief  Rebuild the wheel from the single button objects.
+  * @param  button: Pointer to the bits button object.
+  * @retval None
+  */
+static void wheel_load(bits_button_t *button)
+{
+    for (size_t s = 0; s < BITS_BTN_WHEEL_LEVELS * BITS_BTN_WHEEL_SLOTS; s++)
+        button->wheel_head[s] = BTN_WHEEL_NONE;
+    for (size_t i = 0; i < BITS_BTN_MAX_BUTTONS; i++)
+        button->wheel_slot[i] = BTN_WHEEL_UNLINKED;
+    button->wheel_count = 0;
+    button->wheel_time = get_button_tick(button);
+    btn_mask_clear(&button->wheel_expired);
+    wake_clear(button);
+
+    for (uint16_t i = 0; i < button->btns_cnt; i++)
+        wheel_sync_key(button, i);
+}
+
+/**
+  * @brief  Advance the unsuppressed single buttons whose timer fired or whose input ends their state.
+  * @param  button: Pointer to the bits button object.
+  * @param  suppression_mask: The suppression mask.
+  * @retval None
+  */
+static void dispatch_wheel_buttons(bits_button_t *button, const bits_btn_mask_t *suppression_mask)
+{
+    bits_btn_mask_t active = btn_mask_andnot(button->btns_valid_mask, *suppression_mask);
+    bits_btn_mask_t pressed = btn_mask_and(active, button->current_mask);
+    bits_btn_mask_t released = btn_mask_andnot(active, button->current_mask);
+
+    // Timers of suppressed keys stay expired until the key is stepped again
+    wheel_advance(button, get_button_tick(button));
+
+    bits_btn_mask_t work = btn_mask_and(btn_mask_or(button->wheel_expired, wake_keys(button, &pressed, &released)), active);
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
     {
-        uint8_t read_gpio_level = button->_read_button_level(&button->btns[i]);
-        if (read_gpio_level == button->btns[i].active_level)
+        button_mask_type_t bits = btn_mask_word(&work, w);
+
+        while (bits)
         {
-            current_physical_mask |= ((button_mask_type_t)1UL << i);
+            uint16_t i = (uint16_t)(w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits));
+
+            bits &= bits - 1;
+            update_button_state_table(button, &button->btns[i], i,
+                                      btn_mask_test_bit(&button->current_mask, i));
+            wheel_sync_key(button, i);
         }
     }
+}
+#endif
 
-    button->current_mask = current_physical_mask;
-    button->last_mask = current_physical_mask;
-    button->state_entry_time = get_button_tick();
+/**
+  * @brief  Advance one button with the engine selected at init. Combo buttons
+  *         take table steps in every engine but the switch one.
+  * @param  button: Pointer to the bits button object.
+  * @param  index: Index of the button, combo buttons follow the single buttons.
+  * @param  btn: Pointer to the button object.
+  * @param  btn_pressed: Flag indicating whether the button is pressed.
+  * @retval None
+  */
+static void run_button_state_machine(bits_button_t *button, size_t index, struct button_obj_t* btn, uint8_t btn_pressed)
+{
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+    if (button->engine != BITS_BTN_ENGINE_SWITCH)
+    {
+        update_button_state_table(button, btn, index, btn_pressed);
+        return;
+    }
+#endif
+    update_button_state_machine(button, btn, index, btn_pressed);
+}
 
-    // Clear the event buffer
-    bits_btn_clear_buffer();
+/**
+  * @brief  Handle the button state based on the current mask and button mask.
+  * @param  button: Pointer to the bits button object.
+  * @param  index: Index of the button, combo buttons follow the single buttons.
+  * @param  btn: Pointer to the button object.
+  * @param  current_mask: The current button mask.
+  * @param  btn_mask: The button mask of the specific button.
+  * @retval None
+  */
+static void handle_button_state(bits_button_t *button, size_t index, struct button_obj_t* btn,
+                                const bits_btn_mask_t *current_mask, const bits_btn_mask_t *btn_mask)
+{
+    uint8_t pressed = btn_mask_contains(current_mask, btn_mask);
+    run_button_state_machine(button, index, btn, pressed);
 }
 
 /**
-  * @brief  Add a bit to the end of the number
-  * @param  state_bits: src number point.
-  * @param  bit: tartget bit
-  * @retval none.
+  * @brief  Dispatch and process combo buttons and generate a suppression mask.
+  * @param  button: Pointer to the bits button object.
+  * @param  suppression_mask: Pointer to store the suppression mask.
+  * @retval None
+  */
+static void dispatch_combo_buttons(bits_button_t *button, bits_btn_mask_t *suppression_mask)
+{
+    if(button->btns_combo_cnt == 0) return;
+
+    bits_btn_mask_t activated_mask;
+    button_mask_type_t candidates[BITS_BTN_COMBO_SET_WORDS];
+    btn_mask_clear(&activated_mask);
+
+    // Idle combos with a released key have nothing to do, visit the rest in priority order
+    combo_candidates(button, candidates);
+
+    for (size_t w = 0; w < BITS_BTN_COMBO_SET_WORDS; w++)
+    {
+        button_mask_type_t bits = candidates[w];
+
+        while (bits)
+        {
+            uint32_t bit = btn_mask_word_ctz(bits);
+            uint16_t combo_index = button->combo_sorted_indices[w * BITS_BTN_MASK_WORD_BITS + bit];
+            button_obj_combo_t* combo = &button->btns_combo[combo_index];
+            const bits_btn_mask_t *combo_mask = &combo->combo_mask;
+
+            bits &= bits - 1;
+
+            // Check if the current combo button is covered by a more specific combo button
+            if (btn_mask_intersects(&activated_mask, combo_mask))
+            {
+                // Already covered, skip processing
+                continue;
+            }
+
+            // Handle state transitions for this combo button
+            handle_button_state(button, button->btns_cnt + combo_index, &combo->btn, &button->current_mask, combo_mask);
+
+            if (combo->btn.current_state == BTN_STATE_IDLE)
+                button->combo_busy_set[w] &= ~((button_mask_type_t)1UL << bit);
+            else
+                button->combo_busy_set[w] |= (button_mask_type_t)1UL << bit;
+
+            if (btn_mask_contains(&button->current_mask, combo_mask) || combo->btn.state_bits)
+            {
+                // Mark the current combo button as activated
+                activated_mask = btn_mask_or(activated_mask, *combo_mask);
+
+                if (combo->suppress)
+                {
+                    *suppression_mask = btn_mask_or(*suppression_mask, *combo_mask);
+                }
+            }
+        }
+    }
+}
+
+/**
+  * @brief  Dispatch and process unsuppressed individual buttons.
+  * @param  button: Pointer to the bits button object.
+  * @param  suppression_mask: The suppression mask.
+  * @retval None
+  */
+static void dispatch_unsuppressed_buttons(bits_button_t *button, const bits_btn_mask_t *suppression_mask)
+{
+    // Idle, released buttons have nothing to do: only visit pressed or busy ones
+    // that are not suppressed by combo buttons
+    bits_btn_mask_t active_mask = btn_mask_andnot(btn_mask_or(button->current_mask, button->non_idle_mask),
+                                                  *suppression_mask);
+
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
+    {
+        button_mask_type_t bits = btn_mask_word(&active_mask, w);
+
+        while (bits)
+        {
+            size_t i = w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits);
+            struct button_obj_t *btn = &button->btns[i];
+
+            bits &= bits - 1;
+            run_button_state_machine(button, i, btn, btn_mask_test_bit(&button->current_mask, i));
+
+            if (btn->current_state == BTN_STATE_IDLE)
+                btn_mask_clear_bit(&button->non_idle_mask, i);
+            else
+                btn_mask_set_bit(&button->non_idle_mask, i);
+        }
+    }
+}
+
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+/**
+  * @brief  Per-key debounce: a key takes its new level once the raw sample has
+  *         differed from the debounced level for BITS_BTN_DEBOUNCE_TICKS ticks in a row.
+  *         Updates button->current_mask, which the dispatch passes consume.
+  * @param  button: Pointer to the bits button object.
+  * @param  raw_mask: Pressed mask sampled on this tick.
+  * @retval None
+  */
+static void debounce_per_key(bits_button_t *button, const bits_btn_mask_t *raw_mask)
+{
+    for (size_t i = 0; i < button->btns_cnt; i++)
+    {
+        if (btn_mask_test_bit(raw_mask, i) == btn_mask_test_bit(&button->current_mask, i))
+        {
+            button->debounce_cnt[i] = 0;
+        }
+        else if (button->debounce_cnt[i] >= BITS_BTN_DEBOUNCE_TICKS)
+        {
+            btn_mask_flip_bit(&button->current_mask, i);
+            button->debounce_cnt[i] = 0;
+        }
+        else
+        {
+            button->debounce_cnt[i]++;
+        }
+    }
+}
+#endif
+
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+/**
+  * @brief  Vertical-counter debounce: the same per-key counters as debounce_per_key(),
+  *         stored as bit-planes (plane b holds bit b of every key's counter) so that
+  *         all keys are updated with a fixed number of mask operations and no branches.
+  * @param  button: Pointer to the bits button object.
+  * @param  raw_mask: Pressed mask sampled on this tick.
+  * @retval None
+  */
+static void debounce_vertical(bits_button_t *button, const bits_btn_mask_t *raw_mask)
+{
+    bits_btn_mask_t *planes = button->debounce_planes;
+    bits_btn_mask_t delta = btn_mask_xor(*raw_mask, button->current_mask);
+    bits_btn_mask_t settled = delta;
+    bits_btn_mask_t carry;
+
+    for (size_t b = 0; b < BITS_BTN_DEBOUNCE_PLANES; b++)
+    {
+        // Keys that agree with their debounced level restart from zero
+        planes[b] = btn_mask_and(planes[b], delta);
+
+        // Keep the keys whose counter equals BITS_BTN_DEBOUNCE_TICKS
+        if ((BITS_BTN_DEBOUNCE_TICKS >> b) & 1U)
+            settled = btn_mask_and(settled, planes[b]);
+        else
+            settled = btn_mask_andnot(settled, planes[b]);
+    }
+
+    button->current_mask = btn_mask_xor(button->current_mask, settled);
+
+    // Ripple-carry increment of the pending keys, settled keys restart from zero
+    carry = btn_mask_andnot(delta, settled);
+    for (size_t b = 0; b < BITS_BTN_DEBOUNCE_PLANES; b++)
+    {
+        bits_btn_mask_t next_carry = btn_mask_and(planes[b], carry);
+        planes[b] = btn_mask_andnot(btn_mask_xor(planes[b], carry), settled);
+        carry = next_carry;
+    }
+}
+#endif
+
+/**
+  * @brief  Run one tick of the engine on an already sampled pressed mask.
+  * @param  button: Pointer to the bits button object.
+  * @param  new_mask: Pressed mask for this tick.
+  * @retval None
+  */
+static void bits_btn_process_tick(bits_button_t *button, bits_btn_mask_t new_mask)
+{
+    uint32_t current_time = get_button_tick(button);
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+    // A result held back by BITS_BTN_OVERFLOW_COALESCE goes out once the consumer made room
+    if (button->ring_buffer.held_valid)
+    {
+        bits_btn_flush_held_c11(&button->ring_buffer);
+#ifdef BITS_BTN_HAS_READER_NOTIFY
+        if (!button->ring_buffer.held_valid)
+            bits_btn_notify_readers(button);
+#endif
+#ifdef BITS_BTN_ENABLE_STATS
+        stats_note_held_published(button);
+#endif
+    }
+#endif
+
+    bits_btn_state_write_begin(button);
+
+    button->btn_tick++;
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    timestamp_publish_tick(button);
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    timestamp_raw_edges(button, &new_mask);
+#endif
+
+    if(!btn_mask_equal(&button->last_mask, &new_mask))
+    {
+        if(button->debounce_mode == BITS_BTN_DEBOUNCE_GLOBAL)
+            button->state_entry_time = current_time;
+        debug_print_mask(button, &new_mask);
+        button->last_mask = new_mask;
+    }
+
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    if(button->debounce_mode == BITS_BTN_DEBOUNCE_VERTICAL)
+    {
+        debounce_vertical(button, &new_mask);
+    }
+    else
+#endif
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    if(button->debounce_mode == BITS_BTN_DEBOUNCE_PER_KEY)
+    {
+        debounce_per_key(button, &new_mask);
+    }
+    else
+#endif
+    {
+        button->current_mask = new_mask;
+
+        uint32_t time_diff = current_time - button->state_entry_time;
+
+        if(time_diff * BITS_BTN_TICKS_INTERVAL  < BITS_BTN_DEBOUNCE_TIME_MS)
+        {
+            bits_btn_state_write_end(button);
+            return;
+        }
+    }
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    timestamp_accepted_edges(button);
+#endif
+
+    bits_btn_mask_t suppressed_mask;
+    btn_mask_clear(&suppressed_mask);
+
+    dispatch_combo_buttons(button, &suppressed_mask);
+
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_BITSLICE)
+        dispatch_bitslice_buttons(button, &suppressed_mask);
+    else
+#endif
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_SOA)
+        dispatch_soa_buttons(button, &suppressed_mask);
+    else
+#endif
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+    if (button->engine == BITS_BTN_ENGINE_WHEEL)
+        dispatch_wheel_buttons(button, &suppressed_mask);
+    else
+#endif
+        dispatch_unsuppressed_buttons(button, &suppressed_mask);
+
+    bits_btn_state_write_end(button);
+}
+
+void bits_button_ticks_ctx(bits_button_t *button)
+{
+    bits_btn_process_tick(button, read_pressed_mask(button));
+}
+
+void bits_button_ticks(void)
+{
+    bits_button_ticks_ctx(&bits_btn_entity);
+}
+
+/**
+  * @brief  Ticks from now until a threshold measured from entry_time is exceeded.
+  *         Mirrors the "time_diff * BITS_BTN_TICKS_INTERVAL > threshold_ms" checks
+  *         of the state machine.
+  * @param  now: Tick the state machine will see on the next bits_button_ticks() call.
+  * @param  entry_time: Tick the current state was entered.
+  * @param  threshold_ms: Threshold in milliseconds.
+  * @retval Number of ticks to wait, 0 if the threshold is already exceeded.
   */
-static void __append_bit(state_bits_type_t* state_bits, uint8_t bit)
+static uint32_t ticks_until_exceeded(uint32_t now, uint32_t entry_time, uint32_t threshold_ms)
 {
-    *state_bits = (*state_bits << 1) | bit;
+    uint32_t needed = threshold_ms / BITS_BTN_TICKS_INTERVAL + 1;
+    uint32_t elapsed = now - entry_time;
+
+    return (elapsed >= needed) ? 0 : needed - elapsed;
 }
 
 /**
-  * @brief  check number if match the target bits
-  * @param  state_bits: src number point.
-  * @param  target: tartget bits
-  * @param  target_bits_number: target bits number
-  * @retval 1 if it matches, 0 otherwise.
+  * @brief  Ticks from now until the state machine of a button acts, given a stable input.
+  * @param  btn: Pointer to the button object.
+  * @param  btn_pressed: Input seen by the state machine.
+  * @param  now: Tick the state machine will see on the next bits_button_ticks() call.
+  * @retval Number of ticks to wait, or BITS_BTN_TICKS_INFINITE if the button stays put.
   */
-static uint8_t __check_if_the_bits_match(const key_value_type_t *state_bits, key_value_type_t target, uint8_t target_bits_number)
+static uint32_t btn_ticks_until_transition(const struct button_obj_t* btn, uint8_t btn_pressed, uint32_t now)
 {
-    key_value_type_t mask = (1 << target_bits_number) - 1;
+    if(btn->param == NULL)
+        return BITS_BTN_TICKS_INFINITE;
 
-    return (((*state_bits) & mask) == target? 1 : 0);
+    switch (btn->current_state)
+    {
+        case BTN_STATE_IDLE:
+            return btn_pressed ? 0 : BITS_BTN_TICKS_INFINITE;
+        case BTN_STATE_PRESSED:
+            if (btn_pressed == 0)
+                return 0;
+            return ticks_until_exceeded(now, btn->state_entry_time, btn->param->long_press_start_time_ms);
+        case BTN_STATE_LONG_PRESS:
+            if (btn_pressed == 0)
+                return 0;
+            return ticks_until_exceeded(now, btn->state_entry_time, btn->param->long_press_period_triger_ms);
+        case BTN_STATE_RELEASE_WINDOW:
+            if (btn_pressed)
+                return 0;
+            return ticks_until_exceeded(now, btn->state_entry_time, btn->param->time_window_time_ms);
+        case BTN_STATE_RELEASE:
+        case BTN_STATE_FINISH:
+        default:
+            return 0;
+    }
 }
 
-#if 0
-uint8_t check_is_repeat_click_mode(struct button_obj_t* button)
+uint32_t bits_button_get_next_deadline_ctx(bits_button_t *button)
 {
-    key_value_type_t kv_input = button->key_value;
+    // The next call debounces against the tick before its increment,
+    // while the state machines run on the tick after it
+    uint32_t now = get_button_tick(button);
+    uint32_t btn_now = now + 1;
+    uint32_t wait = BITS_BTN_TICKS_INFINITE;
+    uint32_t btn_wait;
+    bits_btn_mask_t suppressed_mask;
+    bits_btn_mask_t activated_mask;
+
+    btn_mask_clear(&suppressed_mask);
+    btn_mask_clear(&activated_mask);
+
+    // Keys still settling in per-key and vertical modes count on every tick
+    if (!btn_mask_equal(&button->last_mask, &button->current_mask))
+        return 1;
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+    // The next tick publishes a held back result
+    if (button->ring_buffer.held_valid && !bits_btn_is_buffer_full_c11(&button->ring_buffer))
+        return 1;
+#endif
 
-    /* Check if the two least significant bits form 0b10 */
-    if((kv_input & 0b11) != 0b10)
-        return 0;
+    // Walk the combos in dispatch order to rebuild the suppression mask
+    button_mask_type_t candidates[BITS_BTN_COMBO_SET_WORDS];
+    combo_candidates(button, candidates);
 
-    /* Calculate the XOR result */
-    key_value_type_t xor_result = kv_input ^ (kv_input >> 1);
+    for (size_t w = 0; w < BITS_BTN_COMBO_SET_WORDS; w++)
+    {
+        button_mask_type_t bits = candidates[w];
 
-    /* Check if xor_result + 1 is a power of 2
-       This means all bits except the least significant one are 1 */
-    return (xor_result != 0) && (((xor_result + 1) & (xor_result - 1)) == 0);
-}
-#endif
+        while (bits)
+        {
+            button_obj_combo_t* combo = &button->btns_combo[button->combo_sorted_indices[w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits)]];
+            const bits_btn_mask_t *combo_mask = &combo->combo_mask;
 
-/**
-  * @brief  Report a button event.
-  * @param  button: Pointer to the button object.
-  * @param  result: Pointer to the button result to be reported.
-  * @retval None
-  */
-static void bits_btn_report_event(struct button_obj_t* button, bits_btn_result_t *result)
-{
-    bits_btn_result_callback btn_result_cb = bits_btn_entity.bits_btn_result_cb;
+            bits &= bits - 1;
+            if (btn_mask_intersects(&activated_mask, combo_mask))
+                continue;
 
-    if(result == NULL) return;
+            uint8_t pressed = btn_mask_contains(&button->current_mask, combo_mask);
+            btn_wait = btn_ticks_until_transition(&combo->btn, pressed, btn_now);
+            if (btn_wait < wait)
+                wait = btn_wait;
 
-    if(debug_printf)
-        debug_printf("key id[%d],event:%d, long trigger_cnt:%d, key_value:", result->key_id, result->event ,result->long_press_period_trigger_cnt);
-    debug_print_binary(result->key_value);
+            if (pressed || combo->btn.state_bits)
+            {
+                activated_mask = btn_mask_or(activated_mask, *combo_mask);
+                if (combo->suppress)
+                    suppressed_mask = btn_mask_or(suppressed_mask, *combo_mask);
+            }
+        }
+    }
 
-#ifndef BITS_BTN_DISABLE_BUFFER
-    uint8_t is_user_result_filter_exist = (bits_btn_result_user_filter_cb != NULL);
-    uint8_t default_result_filter_triger = (result->event == BTN_EVENT_LONG_PRESS) || (result->event == BTN_EVENT_FINISH);
+    bits_btn_mask_t active_mask = btn_mask_andnot(btn_mask_or(button->current_mask, button->non_idle_mask),
+                                                  suppressed_mask);
 
-    if (bits_btn_buffer_ops && bits_btn_buffer_ops->write)
+    for (size_t w = 0; w < BITS_BTN_MASK_WORDS; w++)
     {
-        uint8_t should_write_to_buffer = 0;
+        button_mask_type_t bits = btn_mask_word(&active_mask, w);
 
-        if (is_user_result_filter_exist)
-        {
-            should_write_to_buffer = bits_btn_result_user_filter_cb(*result);
-        }
-        else
+        while (bits)
         {
-            should_write_to_buffer = default_result_filter_triger;
-        }
+            size_t i = w * BITS_BTN_MASK_WORD_BITS + btn_mask_word_ctz(bits);
 
-        if (should_write_to_buffer)
-        {
-            bits_btn_buffer_ops->write(result);
+            bits &= bits - 1;
+            btn_wait = btn_ticks_until_transition(&button->btns[i], btn_mask_test_bit(&button->current_mask, i), btn_now);
+            if (btn_wait < wait)
+                wait = btn_wait;
         }
     }
-#endif
 
-    if(btn_result_cb)
-        btn_result_cb(button, *result);
+    if (wait == BITS_BTN_TICKS_INFINITE)
+        return BITS_BTN_TICKS_INFINITE;
 
+    // Nothing is processed until the global debounce time has passed
+    uint32_t debounce_elapsed = now - button->state_entry_time;
+    if (button->debounce_mode == BITS_BTN_DEBOUNCE_GLOBAL
+        && debounce_elapsed < BITS_BTN_DEBOUNCE_TICKS && BITS_BTN_DEBOUNCE_TICKS - debounce_elapsed > wait)
+        wait = BITS_BTN_DEBOUNCE_TICKS - debounce_elapsed;
+
+    // Convert "ticks after the next one" into "tick intervals from now"
+    return wait + 1;
 }
 
-/**
-  * @brief  Update the button state machine.
-  * @param  button: Pointer to the button object.
-  * @param  btn_pressed: Flag indicating whether the button is pressed.
-  * @retval None
-  */
-static void update_button_state_machine(struct button_obj_t* button, uint8_t btn_pressed)
+uint32_t bits_button_get_next_deadline(void)
 {
-    uint32_t current_time = get_button_tick();
-    uint32_t time_diff = current_time - button->state_entry_time;
-    bits_btn_result_t result = {0};
-    result.key_id = button->key_id;
+    return bits_button_get_next_deadline_ctx(&bits_btn_entity);
+}
 
-    if(button->param == NULL)
+void bits_button_ticks_elapsed_ctx(bits_button_t *button, uint32_t elapsed_ticks)
+{
+    if (elapsed_ticks == 0)
         return;
 
-    switch (button->current_state)
+    // Replay all but the last tick on the mask sampled before the gap. Only the
+    // ticks where a threshold falls are run, so every event is generated on
+    // its own logical tick; the ones in between are skipped in one step.
+    uint32_t replay_ticks = elapsed_ticks - 1;
+    while (replay_ticks > 0)
     {
-        case BTN_STATE_IDLE:
-            if (btn_pressed)
-            {
-                __append_bit(&button->state_bits, 1);
+        uint32_t wait = bits_button_get_next_deadline_ctx(button);
 
-                button->current_state = BTN_STATE_PRESSED;
-                button->state_entry_time = current_time;
-
-                result.key_value = button->state_bits;
-                result.event = state_to_event((bits_btn_state_t)button->current_state);
-                bits_btn_report_event(button, &result);
-            }
-            break;
-        case BTN_STATE_PRESSED:
-            if (time_diff * BITS_BTN_TICKS_INTERVAL > button->param->long_press_start_time_ms)
-            {
-                __append_bit(&button->state_bits, 1);
-
-                button->current_state = BTN_STATE_LONG_PRESS;
-                button->state_entry_time = current_time;
-                button->long_press_period_trigger_cnt = 0;
-
-                result.key_value = button->state_bits;
-                result.event = state_to_event((bits_btn_state_t)button->current_state);
-                bits_btn_report_event(button, &result);
-            }
-            else if (btn_pressed == 0)
-            {
-                button->current_state = BTN_STATE_RELEASE;
-            }
+        if (wait > replay_ticks)
+        {
+            button->btn_tick += replay_ticks;
             break;
-        case BTN_STATE_LONG_PRESS:
-            if (btn_pressed == 0)
-            {
-                button->long_press_period_trigger_cnt = 0;
-                button->current_state = BTN_STATE_RELEASE;
-            }
-            else if(time_diff * BITS_BTN_TICKS_INTERVAL > button->param->long_press_period_triger_ms)
-            {
-                button->state_entry_time = current_time;
-                button->long_press_period_trigger_cnt++;
+        }
 
-                if(__check_if_the_bits_match(&button->state_bits, 0b011, 3))
-                {
-                    __append_bit(&button->state_bits, 1);
-                }
+        button->btn_tick += wait - 1;
+        replay_ticks -= wait;
+        bits_btn_process_tick(button, button->last_mask);
+    }
 
-                result.key_value = button->state_bits;
-                result.event = state_to_event((bits_btn_state_t)button->current_state);
-                result.long_press_period_trigger_cnt = button->long_press_period_trigger_cnt;
-                bits_btn_report_event(button, &result);
-            }
-            break;
-        case BTN_STATE_RELEASE:
-            __append_bit(&button->state_bits, 0);
+    // The inputs are read only once, on the current tick
+    bits_button_ticks_ctx(button);
+}
 
-            result.key_value = button->state_bits;
-            result.event = BTN_EVENT_RELEASE;
-            bits_btn_report_event(button, &result);
+void bits_button_ticks_elapsed(uint32_t elapsed_ticks)
+{
+    bits_button_ticks_elapsed_ctx(&bits_btn_entity, elapsed_ticks);
+}
 
-            button->current_state = BTN_STATE_RELEASE_WINDOW;
-            button->state_entry_time = current_time;
+uint32_t bits_button_get_tick_ctx(bits_button_t *button)
+{
+    return get_button_tick(button);
+}
 
-            break;
-        case BTN_STATE_RELEASE_WINDOW:
-            if (btn_pressed)
-            {
-                button->current_state = BTN_STATE_IDLE;
-                button->state_entry_time = current_time;
-            }
-            else if (time_diff * BITS_BTN_TICKS_INTERVAL > button->param->time_window_time_ms)
-            {
-                // Time window timeout, trigger event and return to idle
-                button->current_state = BTN_STATE_FINISH;
-            }
-            break;
-        case BTN_STATE_FINISH:
+uint32_t bits_button_get_tick(void)
+{
+    return bits_button_get_tick_ctx(&bits_btn_entity);
+}
 
-            result.key_value = button->state_bits;
-            result.event = BTN_EVENT_FINISH;
-            bits_btn_report_event(button, &result);
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+// ============================================================================
+// Tick Thread
+// ============================================================================
+// The timerfd is armed on absolute CLOCK_MONOTONIC times start + k * period, so
+// the tick's own run time never shifts the schedule. Every read returns the
+// expirations since the last one: one on time, more after a stall, in which
+// case bits_button_ticks_elapsed_ctx() replays the missed intervals.
 
-            button->state_bits = 0;
-            button->current_state = BTN_STATE_IDLE;
-            break;
-        default:
-            break;
+#define BTN_NS_PER_SEC          1000000000ULL
 
-    }
+static uint64_t tick_thread_now_ns(void)
+{
+    struct timespec ts;
 
-    if(button->last_state != button->current_state)
-    {
-#if 0
-        if(debug_printf)
-            debug_printf("id[%d]:cur status:%d,last:%d\n", button->key_id, button->current_state, button->last_state);
-#endif
-        button->last_state = button->current_state;
-    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * BTN_NS_PER_SEC + (uint64_t)ts.tv_nsec;
 }
 
 /**
-  * @brief  Handle the button state based on the current mask and button mask.
-  * @param  button: Pointer to the button object.
-  * @param  current_mask: The current button mask.
-  * @param  btn_mask: The button mask of the specific button.
+  * @brief  Account for one wake-up of the tick thread.
+  * @param  button: Pointer to the bits button object.
+  * @param  expirations: Ticks run on this wake-up.
+  * @param  jitter_ns: Time between the latest expiry and the wake-up.
   * @retval None
   */
-static void handle_button_state(struct button_obj_t* button, button_mask_type_t current_mask, button_mask_type_t btn_mask)
+static void tick_thread_note_wakeup(bits_button_t *button, uint32_t expirations, uint64_t jitter_ns)
 {
-    uint8_t pressed = (current_mask & btn_mask) == btn_mask? 1 : 0;
-    update_button_state_machine(button, pressed);
+    bits_btn_tick_thread_stats_t *stats = &button->tick_stats;
+    uint32_t jitter = jitter_ns > UINT32_MAX ? UINT32_MAX : (uint32_t)jitter_ns;
+    uint64_t jitter_us = jitter_ns / 1000U;
+    uint8_t bucket = 0;
+
+    while (jitter_us && bucket < BITS_BTN_TICK_JITTER_BUCKETS - 1)
+    {
+        bucket++;
+        jitter_us >>= 1;
+    }
+
+    pthread_mutex_lock(&button->tick_stats_lock);
+    stats->wakeups++;
+    stats->ticks += expirations;
+    stats->overruns += expirations - 1;
+    if (expirations > stats->max_catch_up)
+        stats->max_catch_up = expirations;
+    if (stats->wakeups == 1 || jitter < stats->jitter_min_ns)
+        stats->jitter_min_ns = jitter;
+    if (jitter > stats->jitter_max_ns)
+        stats->jitter_max_ns = jitter;
+    stats->jitter_sum_ns += jitter_ns;
+    stats->jitter_hist[bucket]++;
+    pthread_mutex_unlock(&button->tick_stats_lock);
 }
 
 /**
-  * @brief  Dispatch and process combo buttons and generate a suppression mask.
+  * @brief  Destroy the stats lock created by init, once no reader holds it.
+  *         Callers must not start new readers meanwhile.
   * @param  button: Pointer to the bits button object.
-  * @param  suppression_mask: Pointer to store the suppression mask.
   * @retval None
   */
-static void dispatch_combo_buttons(bits_button_t *button, button_mask_type_t *suppression_mask)
+static void tick_thread_destroy_lock(bits_button_t *button)
 {
-    if(button->btns_combo_cnt == 0) return;
+    pthread_mutex_lock(&button->tick_stats_lock);
+    pthread_mutex_unlock(&button->tick_stats_lock);
+    pthread_mutex_destroy(&button->tick_stats_lock);
+}
 
-    button_mask_type_t activated_mask = 0;
+static void *tick_thread_main(void *arg)
+{
+    bits_button_t *button = (bits_button_t *)arg;
+    struct pollfd fds[2] =
+    {
+        { .fd = button->tick_timer_fd, .events = POLLIN },
+        { .fd = button->tick_stop_fd, .events = POLLIN }
+    };
 
-    for (uint16_t i = 0; i < button->btns_combo_cnt; i++)
+    for (;;)
     {
-        uint16_t combo_index = button->combo_sorted_indices[i];
-        button_obj_combo_t* combo = &button->btns_combo[combo_index];
-        button_mask_type_t combo_mask = combo->combo_mask;
+        uint64_t expirations;
 
-        // Check if the current combo button is covered by a more specific combo button
-        if (activated_mask & combo_mask)
+        if (poll(fds, 2, -1) < 0)
         {
-            // Already covered, skip processing
-            continue;
+            if (errno == EINTR)
+                continue;
+            break;
         }
+        if (fds[1].revents)
+            break;
+        if (read(button->tick_timer_fd, &expirations, sizeof(expirations)) != (ssize_t)sizeof(expirations) || expirations == 0)
+            continue;
 
-        // Handle state transitions for this combo button
-        handle_button_state(&combo->btn, button->current_mask, combo_mask);
+        uint64_t now = tick_thread_now_ns();
+        button->tick_expirations += expirations;
+        uint64_t expiry = button->tick_start_ns + button->tick_expirations * button->tick_period_ns;
 
-        if ((button->current_mask & combo_mask) == combo_mask || combo->btn.state_bits)
-        {
-            // Mark the current combo button as activated
-            activated_mask |= combo_mask;
+        // More than 2^32 missed periods cannot be told apart by the 32-bit tick anyway
+        uint32_t elapsed = expirations > UINT32_MAX ? UINT32_MAX : (uint32_t)expirations;
+        bits_button_ticks_elapsed_ctx(button, elapsed);
 
-            if (combo->suppress)
-            {
-                *suppression_mask |= combo_mask;
-            }
-        }
+        tick_thread_note_wakeup(button, elapsed, now > expiry ? now - expiry : 0);
     }
+    return NULL;
 }
 
 /**
-  * @brief  Dispatch and process unsuppressed individual buttons.
+  * @brief  Close the descriptors of the tick thread, keeping errno.
   * @param  button: Pointer to the bits button object.
-  * @param  suppression_mask: The suppression mask.
-  * @retval None
+  * @retval BITS_BTN_ERR_SYSTEM, for the failure paths of the start function.
   */
-static void dispatch_unsuppressed_buttons(bits_button_t *button, button_mask_type_t suppression_mask)
+static int32_t tick_thread_close_fds(bits_button_t *button)
 {
-    // ​​Process Unsuppressed Individual Buttons
-    for (size_t i = 0; i < button->btns_cnt; i++)
+    int err = errno;
+
+    if (button->tick_timer_fd >= 0)
+        close(button->tick_timer_fd);
+    if (button->tick_stop_fd >= 0)
+        close(button->tick_stop_fd);
+    errno = err;
+    return BITS_BTN_ERR_SYSTEM;
+}
+
+/**
+  * @brief  Start a thread that runs the ticks of an instance from a timerfd.
+  * @param  button: Pointer to the bits button object.
+  * @param  config: Thread options, NULL for the defaults.
+  * @retval BITS_BTN_OK, BITS_BTN_ERR_INVALID_PARAM or BITS_BTN_ERR_SYSTEM.
+  */
+int32_t bits_button_start_tick_thread_ctx(bits_button_t *button, const bits_btn_tick_thread_config_t *config)
+{
+    static const bits_btn_tick_thread_config_t default_config = BITS_BTN_TICK_THREAD_CONFIG_INIT;
+    pthread_attr_t attr;
+    int err;
+
+    if (config == NULL)
+        config = &default_config;
+    if (button == NULL || button->tick_thread_running
+        || (config->period_us != 0 && config->period_us != BITS_BTN_TICKS_INTERVAL * 1000U)
+        || config->fifo_priority < 0 || config->fifo_priority > sched_get_priority_max(SCHED_FIFO)
+        || config->cpu < -1 || config->cpu >= CPU_SETSIZE)
     {
-        button_mask_type_t btn_mask = ((button_mask_type_t)1UL << i);
+        return BITS_BTN_ERR_INVALID_PARAM;
+    }
 
-        // Skip individual buttons suppressed by combo buttons
-        if (suppression_mask & btn_mask) {
-            continue;
-        }
+    button->tick_period_ns = (uint64_t)BITS_BTN_TICKS_INTERVAL * 1000000U;
+    button->tick_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    button->tick_stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (button->tick_timer_fd < 0 || button->tick_stop_fd < 0)
+        return tick_thread_close_fds(button);
+
+    button->tick_start_ns = tick_thread_now_ns();
+    button->tick_expirations = 0;
+    uint64_t first = button->tick_start_ns + button->tick_period_ns;
+    struct itimerspec its =
+    {
+        .it_interval = { .tv_sec = (time_t)(button->tick_period_ns / BTN_NS_PER_SEC), .tv_nsec = (long)(button->tick_period_ns % BTN_NS_PER_SEC) },
+        .it_value = { .tv_sec = (time_t)(first / BTN_NS_PER_SEC), .tv_nsec = (long)(first % BTN_NS_PER_SEC) }
+    };
+    if (timerfd_settime(button->tick_timer_fd, TFD_TIMER_ABSTIME, &its, NULL) != 0)
+        return tick_thread_close_fds(button);
+
+    pthread_attr_init(&attr);
+    if (config->cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config->cpu, &cpus);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    }
+    if (config->fifo_priority > 0)
+    {
+        struct sched_param param = { .sched_priority = config->fifo_priority };
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
 
-        handle_button_state(&button->btns[i], button->current_mask, btn_mask);
+    pthread_mutex_lock(&button->tick_stats_lock);
+    memset(&button->tick_stats, 0, sizeof(button->tick_stats));
+    pthread_mutex_unlock(&button->tick_stats_lock);
+
+    // Affinity and priority are applied by pthread_create, which reports EPERM and EINVAL
+    err = pthread_create(&button->tick_thread, &attr, tick_thread_main, button);
+    pthread_attr_destroy(&attr);
+    if (err != 0)
+    {
+        errno = err;
+        return tick_thread_close_fds(button);
     }
+
+    button->tick_thread_running = 1;
+    return BITS_BTN_OK;
 }
 
-void bits_button_ticks(void)
+int32_t bits_button_start_tick_thread(const bits_btn_tick_thread_config_t *config)
 {
-    bits_button_t *button = &bits_btn_entity;
-    uint32_t current_time = get_button_tick();
+    return bits_button_start_tick_thread_ctx(&bits_btn_entity, config);
+}
 
-    button->btn_tick++;
+/**
+  * @brief  Stop the tick thread of an instance and wait for it to exit.
+  * @param  button: Pointer to the bits button object.
+  * @retval BITS_BTN_OK
+  */
+int32_t bits_button_stop_tick_thread_ctx(bits_button_t *button)
+{
+    if (button == NULL || !button->tick_thread_running)
+        return BITS_BTN_OK;
+
+    eventfd_write(button->tick_stop_fd, 1);
+    pthread_join(button->tick_thread, NULL);
+    close(button->tick_timer_fd);
+    close(button->tick_stop_fd);
+    button->tick_thread_running = 0;
+    return BITS_BTN_OK;
+}
 
-    // Calculate button index
-    button_mask_type_t new_mask = 0;
-    for(size_t i = 0; i < button->btns_cnt; i++)
-    {
-        uint8_t read_gpio_level = button->_read_button_level(&button->btns[i]);
+int32_t bits_button_stop_tick_thread(void)
+{
+    return bits_button_stop_tick_thread_ctx(&bits_btn_entity);
+}
 
-        if (read_gpio_level == button->btns[i].active_level)
-        {
-            new_mask |= ((button_mask_type_t)1UL << i);
-        }
-    }
+/**
+  * @brief  Copy the timing statistics of the tick thread, optionally resetting them.
+  * @param  button: Pointer to the bits button object.
+  * @param  stats: Receives the snapshot, may be NULL.
+  * @param  reset: 1 to zero the statistics after copying them.
+  * @retval None
+  */
+void bits_button_get_tick_thread_stats_ctx(bits_button_t *button, bits_btn_tick_thread_stats_t *stats, uint8_t reset)
+{
+    // The lock lives from init to the next init or deinit, so this may race a start or stop
+    pthread_mutex_lock(&button->tick_stats_lock);
+    if (stats)
+        *stats = button->tick_stats;
+    if (reset)
+        memset(&button->tick_stats, 0, sizeof(button->tick_stats));
+    pthread_mutex_unlock(&button->tick_stats_lock);
+}
+
+void bits_button_get_tick_thread_stats(bits_btn_tick_thread_stats_t *stats, uint8_t reset)
+{
+    bits_button_get_tick_thread_stats_ctx(&bits_btn_entity, stats, reset);
+}
+#endif
 
-    button->current_mask = new_mask;
+/**
+  * @brief  Count the presses recorded in a key's sequence bits.
+  *         Every press starts a run of 1 bits, so this counts the runs.
+  * @param  state_bits: Sequence bits of the key.
+  * @retval Number of presses.
+  */
+static uint8_t count_clicks(state_bits_type_t state_bits)
+{
+    state_bits_type_t run_starts = state_bits & ~(state_bits << 1);
+    uint8_t count = 0;
 
-    // State synchronization and debounce processing
-    if(button->last_mask != new_mask)
+    while (run_starts)
     {
-        button->state_entry_time = current_time;
-        if(debug_printf)
-            debug_printf("NEW MASK %d\n", new_mask);
-        button->last_mask = new_mask;
+        run_starts &= run_starts - 1;
+        count++;
     }
 
-    uint32_t time_diff = current_time - button->state_entry_time;
+    return count;
+}
+
+int32_t bits_button_get_key_state_ctx(bits_button_t *button, uint16_t key_id, bits_btn_key_state_t *state)
+{
+    if (button == NULL || state == NULL)
+        return BITS_BTN_ERR_INVALID_PARAM;
 
-    if(time_diff * BITS_BTN_TICKS_INTERVAL  < BITS_BTN_DEBOUNCE_TIME_MS)
+    int index = _get_btn_index_by_key_id(button, key_id);
+    if (index < 0)
+        return BITS_BTN_ERR_KEY_NOT_FOUND;
+
+    const struct button_obj_t *btn = get_btn_by_map_index(button, index);
+    uint8_t current_state;
+    uint32_t press_start_time;
+    uint32_t now;
+    state_bits_type_t state_bits;
+    size_t seq;
+
+    do
     {
-        return;
-    }
+        seq = bits_btn_state_read_begin(button);
+        current_state = btn->current_state;
+        press_start_time = btn->press_start_time;
+        state_bits = btn->state_bits;
+        now = get_button_tick(button);
+    } while (bits_btn_state_read_retry(button, seq));
+
+    state->held = (current_state == BTN_STATE_PRESSED || current_state == BTN_STATE_LONG_PRESS);
+    state->held_ticks = state->held ? now - press_start_time : 0;
+    state->state_bits = state_bits;
+    state->click_count = count_clicks(state_bits);
 
-    button_mask_type_t suppressed_mask = 0;
+    return BITS_BTN_OK;
+}
 
-    dispatch_combo_buttons(button, &suppressed_mask);
+uint8_t bits_button_is_key_held_ctx(bits_button_t *button, uint16_t key_id)
+{
+    bits_btn_key_state_t state;
+    return (bits_button_get_key_state_ctx(button, key_id, &state) == BITS_BTN_OK) ? state.held : 0;
+}
+
+uint32_t bits_button_get_key_held_ticks_ctx(bits_button_t *button, uint16_t key_id)
+{
+    bits_btn_key_state_t state;
+    return (bits_button_get_key_state_ctx(button, key_id, &state) == BITS_BTN_OK) ? state.held_ticks : 0;
+}
 
-    dispatch_unsuppressed_buttons(button, suppressed_mask);
+uint8_t bits_button_get_key_click_count_ctx(bits_button_t *button, uint16_t key_id)
+{
+    bits_btn_key_state_t state;
+    return (bits_button_get_key_state_ctx(button, key_id, &state) == BITS_BTN_OK) ? state.click_count : 0;
+}
+
+state_bits_type_t bits_button_get_key_state_bits_ctx(bits_button_t *button, uint16_t key_id)
+{
+    bits_btn_key_state_t state;
+    return (bits_button_get_key_state_ctx(button, key_id, &state) == BITS_BTN_OK) ? state.state_bits : 0;
+}
+
+int32_t bits_button_get_key_state(uint16_t key_id, bits_btn_key_state_t *state)
+{
+    return bits_button_get_key_state_ctx(&bits_btn_entity, key_id, state);
+}
+
+uint8_t bits_button_is_key_held(uint16_t key_id)
+{
+    return bits_button_is_key_held_ctx(&bits_btn_entity, key_id);
+}
+
+uint32_t bits_button_get_key_held_ticks(uint16_t key_id)
+{
+    return bits_button_get_key_held_ticks_ctx(&bits_btn_entity, key_id);
+}
+
+uint8_t bits_button_get_key_click_count(uint16_t key_id)
+{
+    return bits_button_get_key_click_count_ctx(&bits_btn_entity, key_id);
+}
+
+state_bits_type_t bits_button_get_key_state_bits(uint16_t key_id)
+{
+    return bits_button_get_key_state_bits_ctx(&bits_btn_entity, key_id);
 }
 
 /**
   * @brief  Debugging function, print the input decimal number in binary format.
-  * @param  None.
+  * @param  button: Pointer to the bits button object.
+  * @param  num: Number to print.
   * @retval None
   */
- static void debug_print_binary(key_value_type_t num) {
+ static void debug_print_binary(bits_button_t *button, key_value_type_t num) {
+    bits_btn_debug_printf_func debug_printf = button->debug_printf;
+
     if(debug_printf == NULL)
         return;
 
@@ -978,3 +4609,24 @@ void bits_button_ticks(void)
 
     debug_printf("\r\n");
 }
+
+/**
+  * @brief  Debugging function, print a new button mask.
+  * @param  button: Pointer to the bits button object.
+  * @param  mask: Mask to print.
+  * @retval None
+  */
+static void debug_print_mask(bits_button_t *button, const bits_btn_mask_t *mask)
+{
+    if(button->debug_printf == NULL)
+        return;
+
+#if BITS_BTN_MASK_WORDS > 1
+    button->debug_printf("NEW MASK 0x");
+    for (size_t i = BITS_BTN_MASK_WORDS; i > 0; i--)
+        button->debug_printf("%08lx", (unsigned long)mask->w[i - 1]);
+    button->debug_printf("\n");
+#else
+    button->debug_printf("NEW MASK %d\n", *mask);
+#endif
+}
@@ -1,14 +1,65 @@
 #ifndef __BITS_BUTTON_H__
 #define __BITS_BUTTON_H__
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// The default buffer mode keeps a lock-free ring inside every bits_button_t instance
+#if !defined(BITS_BTN_DISABLE_BUFFER) && !defined(BITS_BTN_USE_USER_BUFFER)
+#define BITS_BTN_USE_C11_BUFFER
 #ifdef __cplusplus
-extern "C" {
+#include <atomic>
+typedef std::atomic<size_t> bits_btn_atomic_size_t;
+typedef std::atomic<unsigned int> bits_btn_atomic_uint_t;
+#else
+#include <stdatomic.h>
+typedef atomic_size_t bits_btn_atomic_size_t;
+typedef atomic_uint bits_btn_atomic_uint_t;
+#endif
 #endif
 
-#include <stdint.h>
-#include <stdio.h>
+// Define BITS_BTN_ENABLE_WAIT for bits_button_wait_key_result(), which parks
+// the reader on a futex until the tick publishes a result
+#ifdef BITS_BTN_ENABLE_WAIT
+#ifndef BITS_BTN_USE_C11_BUFFER
+#error "BITS_BTN_ENABLE_WAIT needs the built-in C11 ring buffer"
+#endif
+#ifndef __linux__
+#error "BITS_BTN_ENABLE_WAIT is implemented with Linux futexes"
+#endif
+#endif
+
+// Define BITS_BTN_ENABLE_EVENTFD for bits_button_get_event_fd(), an eventfd that
+// becomes readable when the result ring goes from empty to non-empty
+#ifdef BITS_BTN_ENABLE_EVENTFD
+#ifndef BITS_BTN_USE_C11_BUFFER
+#error "BITS_BTN_ENABLE_EVENTFD needs the built-in C11 ring buffer"
+#endif
+#ifndef __linux__
+#error "BITS_BTN_ENABLE_EVENTFD is implemented with Linux eventfd"
+#endif
+#endif
+
+#if defined(BITS_BTN_ENABLE_WAIT) || defined(BITS_BTN_ENABLE_EVENTFD)
+#define BITS_BTN_HAS_READER_NOTIFY
+#endif
+
+// Define BITS_BTN_ENABLE_TICK_THREAD for bits_button_start_tick_thread(), a
+// thread that runs the ticks from an absolute-time timerfd (link with -pthread)
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+#ifndef __linux__
+#error "BITS_BTN_ENABLE_TICK_THREAD is implemented with Linux timerfd"
+#endif
+#include <pthread.h>
+#endif
 
-// The maximum number of combined buttons supported
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The maximum number of combined buttons supported. The per-tick combo matching
+// only visits combos that can be pressed or are busy, so large values are fine.
 #ifndef BITS_BTN_MAX_COMBO_BUTTONS
 #define BITS_BTN_MAX_COMBO_BUTTONS  8
 #endif
@@ -17,8 +68,34 @@ typedef uint32_t key_value_type_t;
 typedef uint32_t state_bits_type_t;
 typedef state_bits_type_t button_mask_type_t;
 
-// Maximum number of buttons based on mask type size
-#define BITS_BTN_MAX_BUTTONS      (sizeof(button_mask_type_t) * 8)
+// Width of one button_mask_type_t word in bits
+#define BITS_BTN_MASK_WORD_BITS   32
+
+// Maximum number of single buttons. Defaults to one mask word; define a larger
+// value (e.g. 128, 256, 1024) to switch to a multi-word bits_btn_mask_t.
+#ifndef BITS_BTN_MAX_BUTTONS
+#define BITS_BTN_MAX_BUTTONS      BITS_BTN_MASK_WORD_BITS
+#endif
+
+#define BITS_BTN_MASK_WORDS       ((BITS_BTN_MAX_BUTTONS + BITS_BTN_MASK_WORD_BITS - 1) / BITS_BTN_MASK_WORD_BITS)
+
+// Words of a combo set, bit r stands for the combo at priority rank r
+#define BITS_BTN_COMBO_SET_WORDS  ((BITS_BTN_MAX_COMBO_BUTTONS + BITS_BTN_MASK_WORD_BITS - 1) / BITS_BTN_MASK_WORD_BITS)
+
+#if BITS_BTN_MASK_WORDS > 1
+// Multi-word button mask, bit i of the set lives in w[i / 32] bit (i % 32)
+typedef struct
+{
+    button_mask_type_t w[BITS_BTN_MASK_WORDS];
+} bits_btn_mask_t;
+#define BITS_BTN_MASK_ZERO_INIT   {{0}}
+#define BITS_BTN_MASK_SET_BIT(_mask, _bit)  \
+    ((_mask).w[(_bit) / BITS_BTN_MASK_WORD_BITS] |= ((button_mask_type_t)1UL << ((_bit) % BITS_BTN_MASK_WORD_BITS)))
+#else
+typedef button_mask_type_t bits_btn_mask_t;
+#define BITS_BTN_MASK_ZERO_INIT   0
+#define BITS_BTN_MASK_SET_BIT(_mask, _bit)  ((_mask) |= ((button_mask_type_t)1UL << (_bit)))
+#endif
 
 /**
  * @brief BitsButton error codes for initialization and operation results.
@@ -27,13 +104,18 @@ typedef state_bits_type_t button_mask_type_t;
 typedef enum {
     BITS_BTN_OK                       =  0,  // Success
     BITS_BTN_ERR_INVALID_COMBO_ID     = -1,  // Combo button references an invalid single button ID
-    BITS_BTN_ERR_INVALID_PARAM        = -2,  // Invalid parameter (config/btns/read_func is NULL, etc.)
+    BITS_BTN_ERR_INVALID_PARAM        = -2,  // Invalid parameter (config/btns is NULL, both read funcs are NULL, etc.)
     BITS_BTN_ERR_TOO_MANY_COMBOS      = -3,  // Number of combo buttons exceeds BITS_BTN_MAX_COMBO_BUTTONS
     BITS_BTN_ERR_BUFFER_OPS_NULL      = -4,  // User buffer mode requires setting buffer ops before init
     BITS_BTN_ERR_TOO_MANY_BUTTONS     = -5,  // Number of buttons exceeds BITS_BTN_MAX_BUTTONS
     BITS_BTN_ERR_BTN_PARAM_NULL       = -6,  // Single button has NULL param pointer
     BITS_BTN_ERR_COMBO_PARAM_NULL     = -7,  // Combo button has NULL param pointer
     BITS_BTN_ERR_COMBO_KEYS_INVALID   = -8,  // Combo button keys config invalid (key_single_ids is NULL or key_count is 0)
+    BITS_BTN_ERR_KEY_NOT_FOUND        = -9,  // No single or combo button with the requested key ID
+    BITS_BTN_ERR_PARAM_MISMATCH       = -10, // Bit-sliced engine requires every single button to use the same params
+    BITS_BTN_ERR_TOO_MANY_PATTERNS    = -11, // Registered patterns need more than BITS_BTN_MAX_PATTERN_NODES trie nodes
+    BITS_BTN_ERR_TOO_MANY_HANDLERS    = -12, // Registered handlers exceed BITS_BTN_HANDLER_MAP_SIZE
+    BITS_BTN_ERR_SYSTEM               = -13, // A system call failed, see errno
 } bits_btn_error_t;
 
 
@@ -53,6 +135,108 @@ typedef enum {
 #define BITS_BTN_DEBOUNCE_TIME_MS            (40)
 #endif
 
+/**
+ * @brief Debounce strategy applied to the sampled button mask.
+ */
+typedef enum {
+    BITS_BTN_DEBOUNCE_GLOBAL = 0,   // Any mask change restarts one shared debounce window (default)
+    BITS_BTN_DEBOUNCE_PER_KEY,      // Every key settles on its own counter, needs BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    BITS_BTN_DEBOUNCE_VERTICAL,     // Same as PER_KEY with bit-sliced counters, needs BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+} bits_btn_debounce_mode_t;
+
+/**
+ * @brief Implementation of the per-button state machine. Every engine reports the same events.
+ */
+typedef enum {
+    BITS_BTN_ENGINE_SWITCH = 0,     // Switch over the states, reads the params on every tick (default)
+    BITS_BTN_ENGINE_TABLE,          // Params precomputed into tick thresholds, transitions looked up in a table, needs BITS_BTN_ENABLE_TABLE_ENGINE
+    BITS_BTN_ENGINE_BITSLICE,       // All single buttons advanced at once with mask logic, needs identical params and BITS_BTN_ENABLE_BITSLICE_ENGINE
+    BITS_BTN_ENGINE_SOA,            // Structure-of-arrays timers checked with SIMD, needs BITS_BTN_ENABLE_SOA_ENGINE
+    BITS_BTN_ENGINE_WHEEL,          // Timeouts scheduled on a timer wheel, needs BITS_BTN_ENABLE_WHEEL_ENGINE
+} bits_btn_engine_t;
+
+/**
+ * @brief What the built-in result ring does with a result when it is full.
+ */
+typedef enum {
+    BITS_BTN_OVERFLOW_OVERWRITE_OLDEST = 0, // Drop the oldest queued result (default)
+    BITS_BTN_OVERFLOW_DROP_NEWEST,          // Drop the result being written
+    BITS_BTN_OVERFLOW_COALESCE,             // Hold one result back; drop only long press repeats, merging those of one key
+} bits_btn_overflow_policy_t;
+
+// Define BITS_BTN_ENABLE_BITSLICE_ENGINE to build the bit-sliced engine. Its per-key
+// age counters take enough bit-planes for any uint16_t tick threshold.
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+#define BITS_BTN_SLICE_AGE_PLANES   17
+#endif
+
+// Define BITS_BTN_ENABLE_SOA_ENGINE to build the structure-of-arrays engine. On x86-64
+// GCC/Clang its timeout check uses SSE2 or AVX2 (picked at init from the CPU), unless
+// BITS_BTN_SOA_NO_SIMD is defined. The arrays are padded to whole 8-lane vectors.
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+#define BITS_BTN_SOA_SLOTS          ((BITS_BTN_MAX_BUTTONS + 7) / 8 * 8)
+#endif
+
+// Define BITS_BTN_ENABLE_WHEEL_ENGINE to build the timer wheel engine. Its hierarchical
+// wheel has levels of 2^BITS_BTN_WHEEL_SLOT_BITS slots, as many as it takes to reach
+// 65536 ticks ahead: the longest uint16_t threshold plus one.
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+#ifndef BITS_BTN_WHEEL_SLOT_BITS
+#define BITS_BTN_WHEEL_SLOT_BITS    4
+#endif
+#if BITS_BTN_WHEEL_SLOT_BITS < 1 || BITS_BTN_WHEEL_SLOT_BITS > 6
+#error "BITS_BTN_WHEEL_SLOT_BITS must be between 1 and 6"
+#endif
+#define BITS_BTN_WHEEL_SLOTS        (1 << BITS_BTN_WHEEL_SLOT_BITS)
+#define BITS_BTN_WHEEL_LEVELS       ((16 + BITS_BTN_WHEEL_SLOT_BITS - 1) / BITS_BTN_WHEEL_SLOT_BITS)
+#endif
+
+#if defined(BITS_BTN_ENABLE_SOA_ENGINE) || defined(BITS_BTN_ENABLE_WHEEL_ENGINE)
+#define BITS_BTN_HAS_WAKE_MASKS
+#endif
+
+// Define BITS_BTN_ENABLE_TABLE_ENGINE to build the table-driven engine and the tick
+// thresholds it precomputes per key. The bit-sliced, SoA and wheel engines step their
+// keys through its table and turn it on.
+#if (defined(BITS_BTN_ENABLE_BITSLICE_ENGINE) || defined(BITS_BTN_ENABLE_SOA_ENGINE) || defined(BITS_BTN_ENABLE_WHEEL_ENGINE)) \
+    && !defined(BITS_BTN_ENABLE_TABLE_ENGINE)
+#define BITS_BTN_ENABLE_TABLE_ENGINE
+#endif
+
+// Define BITS_BTN_ENABLE_PER_KEY_DEBOUNCE to build BITS_BTN_DEBOUNCE_PER_KEY. Its
+// counters take one byte per single button.
+// Define BITS_BTN_ENABLE_VERTICAL_DEBOUNCE to build BITS_BTN_DEBOUNCE_VERTICAL. Its
+// counters take BITS_BTN_DEBOUNCE_PLANES masks.
+
+// Debounce time in ticks and the number of bit-planes needed to count up to it
+#define BITS_BTN_DEBOUNCE_TICKS \
+    ((BITS_BTN_DEBOUNCE_TIME_MS + BITS_BTN_TICKS_INTERVAL - 1) / BITS_BTN_TICKS_INTERVAL)
+
+#if defined(BITS_BTN_ENABLE_PER_KEY_DEBOUNCE) || defined(BITS_BTN_ENABLE_VERTICAL_DEBOUNCE)
+#if BITS_BTN_DEBOUNCE_TICKS < 2
+#define BITS_BTN_DEBOUNCE_PLANES    1
+#elif BITS_BTN_DEBOUNCE_TICKS < 4
+#define BITS_BTN_DEBOUNCE_PLANES    2
+#elif BITS_BTN_DEBOUNCE_TICKS < 8
+#define BITS_BTN_DEBOUNCE_PLANES    3
+#elif BITS_BTN_DEBOUNCE_TICKS < 16
+#define BITS_BTN_DEBOUNCE_PLANES    4
+#elif BITS_BTN_DEBOUNCE_TICKS < 32
+#define BITS_BTN_DEBOUNCE_PLANES    5
+#elif BITS_BTN_DEBOUNCE_TICKS < 64
+#define BITS_BTN_DEBOUNCE_PLANES    6
+#elif BITS_BTN_DEBOUNCE_TICKS < 128
+#define BITS_BTN_DEBOUNCE_PLANES    7
+#elif BITS_BTN_DEBOUNCE_TICKS < 256
+#define BITS_BTN_DEBOUNCE_PLANES    8
+#else
+#error "BITS_BTN_DEBOUNCE_TIME_MS is too long for the 8-bit per-key debounce counters"
+#endif
+#endif
+
+// Returned by bits_button_get_next_deadline() when no transition is pending
+#define BITS_BTN_TICKS_INFINITE              UINT32_MAX
+
 #define BITS_BTN_SHORT_TIME_MS               (350)
 #define BITS_BTN_LONG_PRESS_START_TIME_MS    (1000)
 #define BITS_BTN_LONG_PRESS_PERIOD_TRIGER_MS (1000)
@@ -85,22 +269,34 @@ typedef enum {
 #define BITS_BUTTON_INIT(_key_id, _active_level, _param)                                    \
 {                                                                                           \
     .active_level = _active_level, .current_state = 0, .last_state = 0, .key_id = _key_id,  \
-    .long_press_period_trigger_cnt = 0, .state_entry_time = 0,                              \
+    .long_press_period_trigger_cnt = 0, .state_entry_time = 0, .press_start_time = 0,       \
     .state_bits = 0, .param = _param                                                        \
 }
 
 #define BITS_BUTTON_COMBO_INIT(_key_id, _active_level, _param, _key_single_ids, _key_count, _single_key_suppress)   \
 {                                                                                                                   \
-    .suppress = _single_key_suppress, .key_count = _key_count, .key_single_ids = _key_single_ids, .combo_mask = 0,  \
+    .suppress = _single_key_suppress, .key_count = _key_count, .key_single_ids = _key_single_ids,                   \
+    .combo_mask = BITS_BTN_MASK_ZERO_INIT,                                                                          \
     .btn = BITS_BUTTON_INIT(_key_id, _active_level, _param)                                                         \
 }
 
+// Define BITS_BTN_ENABLE_EVENT_TIMESTAMPS to stamp every result with the ticks
+// (see bits_button_get_tick()) of its input edge, debounce acceptance and report.
+// BITS_BTN_ENABLE_STATS measures its latencies from these stamps and turns them on.
+#if defined(BITS_BTN_ENABLE_STATS) && !defined(BITS_BTN_ENABLE_EVENT_TIMESTAMPS)
+#define BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+#endif
 typedef struct bits_btn_result
 {
     uint8_t event;
     uint16_t key_id;
     uint16_t long_press_period_trigger_cnt;
     state_bits_type_t key_value;
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    uint32_t edge_tick;                 // Tick the raw input of the key (latest key of a combo) first left its accepted level
+    uint32_t accept_tick;               // Tick the state machine saw that change, after debouncing
+    uint32_t report_tick;               // Tick the event was generated on
+#endif
 } bits_btn_result_t;
 
 typedef struct bits_btn_obj_param
@@ -118,11 +314,13 @@ typedef struct button_obj_t {
     uint16_t  key_id;
     uint16_t long_press_period_trigger_cnt;
     uint32_t state_entry_time;
+    uint32_t press_start_time;
     state_bits_type_t state_bits;
     const bits_btn_obj_param_t *param;
 } button_obj_t;
 
 typedef uint8_t (*bits_btn_read_button_level)(struct button_obj_t *btn);
+typedef bits_btn_mask_t (*bits_btn_read_button_mask)(void);
 typedef void (*bits_btn_result_callback)(struct button_obj_t *btn, struct bits_btn_result button_result);
 typedef int (*bits_btn_debug_printf_func)(const char*, ...);
 typedef uint8_t (*bits_btn_result_user_filter_callback)(bits_btn_result_t button_result);
@@ -132,26 +330,356 @@ typedef struct button_obj_combo
     uint8_t suppress;
     uint8_t key_count;
     uint16_t *key_single_ids;
-    button_mask_type_t combo_mask;
+    bits_btn_mask_t combo_mask;
 
     button_obj_t btn;
 } button_obj_combo_t;
 
+#ifdef BITS_BTN_USE_C11_BUFFER
+// Define BITS_BTN_NO_BUILTIN_BUFFER to drop the built-in BITS_BTN_BUFFER_SIZE
+// slots from every instance; bits_btn_config_t.buffer_storage is then required
+#ifndef BITS_BTN_BUFFER_SIZE
+#ifdef BITS_BTN_USE_POW2_BUFFER
+#define BITS_BTN_BUFFER_SIZE        16
+#else
+#define BITS_BTN_BUFFER_SIZE        10
+#endif
+#endif
+
+#ifdef BITS_BTN_USE_POW2_BUFFER
+#if BITS_BTN_BUFFER_SIZE < 2 || (BITS_BTN_BUFFER_SIZE & (BITS_BTN_BUFFER_SIZE - 1)) != 0
+#error "BITS_BTN_USE_POW2_BUFFER requires BITS_BTN_BUFFER_SIZE to be a power of two"
+#endif
+
+#ifndef BITS_BTN_CACHE_LINE_SIZE
+#define BITS_BTN_CACHE_LINE_SIZE    64
+#endif
+
+// Starts a member on its own cache line; only C11 and C++11 can express it
+#if defined(__cplusplus)
+#define BITS_BTN_CACHE_ALIGNED      alignas(BITS_BTN_CACHE_LINE_SIZE)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define BITS_BTN_CACHE_ALIGNED      _Alignas(BITS_BTN_CACHE_LINE_SIZE)
+#else
+#define BITS_BTN_CACHE_ALIGNED
+#endif
+
+// Free-running indices masked into the slots, so every slot is usable. The
+// producer and consumer indices sit on separate cache lines to avoid false sharing.
+typedef struct
+{
+#ifndef BITS_BTN_NO_BUILTIN_BUFFER
+    bits_btn_result_t buffer[BITS_BTN_BUFFER_SIZE];
+#endif
+    bits_btn_result_t *slots;                 // buffer, or the storage passed in bits_btn_config_t
+    size_t size;                              // Slots behind slots, a power of two
+    BITS_BTN_CACHE_ALIGNED bits_btn_atomic_size_t write_idx;  // Written by the producer only
+    bits_btn_atomic_size_t overwrite_count;   // Number of events dropped by overwrite
+    bits_btn_result_t held;                   // Result held back by BITS_BTN_OVERFLOW_COALESCE, producer only
+    uint8_t held_valid;
+#ifdef BITS_BTN_ENABLE_STATS
+    uint8_t held_published;                   // Held results moved into the ring since the statistics took them
+#endif
+    uint8_t overflow_policy;                  // bits_btn_overflow_policy_t
+    BITS_BTN_CACHE_ALIGNED bits_btn_atomic_size_t read_idx;  // Claimed by compare-and-swap, the producer moves it on overwrite
+} bits_btn_ring_buffer_t;
+#else
+typedef struct
+{
+#ifndef BITS_BTN_NO_BUILTIN_BUFFER
+    bits_btn_result_t buffer[BITS_BTN_BUFFER_SIZE];
+#endif
+    bits_btn_result_t *slots;                 // buffer, or the storage passed in bits_btn_config_t
+    size_t size;                              // Slots behind slots, one is kept free
+    bits_btn_atomic_size_t read_idx;          // Atomic read index
+    bits_btn_atomic_size_t write_idx;         // Atomic write index
+    bits_btn_atomic_size_t overwrite_count;   // Number of events dropped by overwrite
+    bits_btn_result_t held;                   // Result held back by BITS_BTN_OVERFLOW_COALESCE, producer only
+    uint8_t held_valid;
+#ifdef BITS_BTN_ENABLE_STATS
+    uint8_t held_published;                   // Held results moved into the ring since the statistics took them
+#endif
+    uint8_t overflow_policy;                  // bits_btn_overflow_policy_t
+} bits_btn_ring_buffer_t;
+#endif
+#endif
+
+// Define BITS_BTN_ENABLE_KEY_MAP to look key IDs up in a hash map instead of scanning
+// the buttons. Slots of the key_id -> index map, twice the number of keys keeps probe chains short.
+#ifndef BITS_BTN_KEY_MAP_SIZE
+#define BITS_BTN_KEY_MAP_SIZE   (2 * (BITS_BTN_MAX_BUTTONS + BITS_BTN_MAX_COMBO_BUTTONS))
+#endif
+
+// Define BITS_BTN_ENABLE_PATTERNS to build the pattern_sets of bits_btn_config_t.
+// Its trie nodes are shared by all registered pattern sets. A set takes one node for its
+// root plus one per pattern bit not shared with an earlier pattern of the set;
+// sets passing the same patterns array share one trie.
+#ifndef BITS_BTN_MAX_PATTERN_NODES
+#define BITS_BTN_MAX_PATTERN_NODES  32
+#endif
+
+/**
+ * @brief Timeouts of one button in ticks, precomputed from its bits_btn_obj_param_t
+ *        for the table engine. A state times out once the ticks spent in it exceed its slot.
+ */
+typedef struct
+{
+    uint16_t timeout_ticks[4];          // Unused, long press start, long press period, time window
+} bits_btn_tick_param_t;
+
+/**
+ * @brief The key_values one key acts on. Once state_bits can no longer grow into
+ *        any of them, the key skips its time window and reports FINISH on the next tick.
+ */
+typedef struct
+{
+    uint16_t key_id;                    // Single or combo button
+    uint8_t pattern_cnt;
+    const state_bits_type_t *patterns;  // e.g. BITS_BTN_SINGLE_CLICK_KV, BITS_BTN_DOUBLE_CLICK_KV
+} bits_btn_pattern_set_t;
+
+// Define BITS_BTN_ENABLE_HANDLERS to build the handlers of bits_btn_config_t.
+// Slots of the (key_id, event, key_value) -> handler table, must hold every
+// registered handler; twice the handler count keeps probe chains short
+#ifndef BITS_BTN_HANDLER_MAP_SIZE
+#define BITS_BTN_HANDLER_MAP_SIZE   32
+#endif
+
+// key_value of a handler that runs for every key_value of its key and event
+#define BITS_BTN_ANY_KEY_VALUE      0
+
+typedef void (*bits_btn_handler_func)(bits_btn_result_t result, void *user_data);
+
+/**
+ * @brief One entry of the handler table. A result runs the handler registered for its
+ *        exact (key_id, event, key_value), or else the one registered with BITS_BTN_ANY_KEY_VALUE.
+ */
+typedef struct
+{
+    uint16_t key_id;                    // Single or combo button
+    uint8_t event;                      // bits_btn_event_t
+    state_bits_type_t key_value;        // e.g. BITS_BTN_DOUBLE_CLICK_KV, or BITS_BTN_ANY_KEY_VALUE
+    bits_btn_handler_func handler;
+    void *user_data;                    // Passed back to the handler
+} bits_btn_handler_t;
+
+/**
+ * @brief Snapshot of one key's state, see bits_button_get_key_state().
+ */
+typedef struct
+{
+    uint8_t held;                       // 1 while the key is in the pressed or long press state
+    uint8_t click_count;                // Presses in the current click sequence
+    uint32_t held_ticks;                // Ticks since the current press started, 0 when not held
+    state_bits_type_t state_bits;       // Sequence bits recorded so far (the key_value of the next FINISH)
+} bits_btn_key_state_t;
+
+#ifdef BITS_BTN_ENABLE_STATS
+// Latency histogram buckets: bucket 0 counts 0 ticks, bucket b counts
+// [2^(b-1), 2^b) ticks, and the last bucket also takes everything longer
+#ifndef BITS_BTN_STATS_BUCKETS
+#define BITS_BTN_STATS_BUCKETS      16
+#endif
+#if BITS_BTN_STATS_BUCKETS < 2 || BITS_BTN_STATS_BUCKETS > 33
+#error "BITS_BTN_STATS_BUCKETS must be between 2 and 33"
+#endif
+
+// Histograms indexed by bits_btn_event_t; unused event values stay at zero
+#define BITS_BTN_STATS_EVENT_TYPES  (BTN_EVENT_FINISH + 1)
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+typedef bits_btn_atomic_size_t bits_btn_stat_counter_t;
+#else
+typedef volatile size_t bits_btn_stat_counter_t;
+#endif
+
+/**
+ * @brief Event pipeline statistics, see bits_button_get_stats().
+ *        Latencies are in ticks and taken from the result timestamps.
+ */
+typedef struct
+{
+    size_t reported;                                    // Events reported by the state machines
+    size_t buffered;                                    // Results written to the buffer
+    size_t dequeued;                                    // Results read from the buffer
+    size_t occupancy_high_watermark;                    // Most results the buffer held right after a write
+    size_t queue_latency[BITS_BTN_STATS_BUCKETS];       // report_tick to read, per bucket
+    size_t report_latency[BITS_BTN_STATS_EVENT_TYPES][BITS_BTN_STATS_BUCKETS];  // accept_tick to report_tick, per event type
+} bits_btn_stats_t;
+
+// Live counters of an instance; every counter has a single writer, the tick
+// (reported, buffered, occupancy, report latency) or the reader (the rest)
+typedef struct
+{
+    bits_btn_stat_counter_t reported;
+    bits_btn_stat_counter_t buffered;
+    bits_btn_stat_counter_t dequeued;
+    bits_btn_stat_counter_t occupancy_high_watermark;
+    bits_btn_stat_counter_t queue_latency[BITS_BTN_STATS_BUCKETS];
+    bits_btn_stat_counter_t report_latency[BITS_BTN_STATS_EVENT_TYPES][BITS_BTN_STATS_BUCKETS];
+} bits_btn_stats_counters_t;
+#endif
+
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+// Wake-up jitter histogram buckets: bucket 0 counts less than 1 us, bucket b
+// counts [2^(b-1), 2^b) us, and the last bucket also takes everything later
+#ifndef BITS_BTN_TICK_JITTER_BUCKETS
+#define BITS_BTN_TICK_JITTER_BUCKETS    16
+#endif
+
+/**
+ * @brief Options of bits_button_start_tick_thread(). Start from BITS_BTN_TICK_THREAD_CONFIG_INIT.
+ */
+typedef struct
+{
+    uint32_t period_us;                 // Tick period, 0 or BITS_BTN_TICKS_INTERVAL * 1000; anything else is rejected
+    int cpu;                            // CPU to pin the thread to, -1 for none
+    int fifo_priority;                  // SCHED_FIFO priority 1..99, 0 keeps the default policy
+} bits_btn_tick_thread_config_t;
+
+#define BITS_BTN_TICK_THREAD_CONFIG_INIT    { .period_us = 0, .cpu = -1, .fifo_priority = 0 }
+
+/**
+ * @brief Timing of the tick thread, see bits_button_get_tick_thread_stats().
+ *        Jitter is how late the thread woke behind the timer expiry it handles.
+ */
+typedef struct
+{
+    uint64_t wakeups;                   // Timer reads by the thread
+    uint64_t ticks;                     // Tick intervals run, including caught up ones
+    uint64_t overruns;                  // Expirations that were missed and caught up
+    uint32_t max_catch_up;              // Most tick intervals run in one wake-up
+    uint32_t jitter_min_ns;             // 0 before the first wake-up
+    uint32_t jitter_max_ns;
+    uint64_t jitter_sum_ns;             // Divide by wakeups for the mean
+    uint32_t jitter_hist[BITS_BTN_TICK_JITTER_BUCKETS];
+} bits_btn_tick_thread_stats_t;
+#endif
+
+/**
+ * @brief Button engine instance. Every instance owns its buttons, state and
+ *        (in the default buffer mode) its own result ring buffer, so several
+ *        instances can be ticked from different threads without locking.
+ *        Treat the members as private; use the *_ctx API to operate on them.
+ */
 typedef struct bits_button
 {
+    uint32_t init_magic;                                        // Set by init, cleared by bits_button_deinit_ctx()
     button_obj_t *btns;
     uint16_t btns_cnt;
     button_obj_combo_t *btns_combo;
     uint16_t btns_combo_cnt;
 
-    button_mask_type_t current_mask;
-    button_mask_type_t last_mask;
+    bits_btn_mask_t current_mask;
+    bits_btn_mask_t last_mask;
+    bits_btn_mask_t non_idle_mask;
     uint32_t state_entry_time;
     uint32_t btn_tick;
     bits_btn_read_button_level _read_button_level;
+    bits_btn_read_button_mask _read_button_mask;
+    bits_btn_mask_t active_level_xor_mask;
+    bits_btn_mask_t btns_valid_mask;
+    uint8_t debounce_mode;
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    uint8_t debounce_cnt[BITS_BTN_MAX_BUTTONS];
+#endif
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    bits_btn_mask_t debounce_planes[BITS_BTN_DEBOUNCE_PLANES];
+#endif
+    uint8_t engine;
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    uint8_t slice_age_planes;                                   // Age planes in use, derived from the largest threshold
+    uint32_t slice_time;                                        // Tick of the last bit-sliced step
+    bits_btn_mask_t slice_state[3];                             // Plane b holds bit b of every single button's state
+    bits_btn_mask_t slice_age[BITS_BTN_SLICE_AGE_PLANES];       // Saturating ticks since each single button's state entry
+#endif
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+    uint8_t soa_kernel;                                         // Timeout kernel picked from the CPU features at init
+    uint32_t soa_entry[BITS_BTN_SOA_SLOTS];                     // State entry tick of every single button
+    uint32_t soa_threshold[BITS_BTN_SOA_SLOTS];                 // Timeout of the current state in ticks, UINT32_MAX for none
+#endif
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+    uint32_t wheel_time;                                        // Last tick the wheel has advanced to
+    uint16_t wheel_count;                                       // Timers currently scheduled
+    uint16_t wheel_head[BITS_BTN_WHEEL_LEVELS * BITS_BTN_WHEEL_SLOTS];  // First key of every slot's list
+    uint16_t wheel_next[BITS_BTN_MAX_BUTTONS];                  // Doubly linked slot lists through the single buttons
+    uint16_t wheel_prev[BITS_BTN_MAX_BUTTONS];
+    uint8_t wheel_slot[BITS_BTN_MAX_BUTTONS];                   // Slot holding each key's timer
+    uint32_t wheel_deadline[BITS_BTN_MAX_BUTTONS];              // First tick on which the key's current state times out
+    bits_btn_mask_t wheel_expired;                              // Keys whose timer fired and that have not stepped since
+#endif
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    bits_btn_mask_t ts_seen_mask;                               // Levels the state machines last ran on
+    bits_btn_mask_t ts_edge_pending;                            // Keys whose raw level differs from ts_seen_mask
+    uint32_t ts_edge_tick[BITS_BTN_MAX_BUTTONS];                // First tick of each key's latest raw edge
+    uint32_t ts_accept_tick[BITS_BTN_MAX_BUTTONS];              // Tick each key's latest edge reached the state machines
+#ifdef BITS_BTN_USE_C11_BUFFER
+    bits_btn_atomic_uint_t ts_published_tick;                   // btn_tick published by the tick for reader threads
+#else
+    volatile uint32_t ts_published_tick;
+#endif
+#endif
+#ifdef BITS_BTN_ENABLE_STATS
+    bits_btn_stats_counters_t stats;
+#endif
+#ifdef BITS_BTN_HAS_WAKE_MASKS
+    bits_btn_mask_t wake_pressed;                               // Keys that leave their state when pressed (idle, release window)
+    bits_btn_mask_t wake_released;                              // Keys that leave their state when released (pressed, long press)
+    bits_btn_mask_t wake_always;                                // Keys in a state that lasts one step (release, finish)
+#endif
     bits_btn_result_callback bits_btn_result_cb;
+    bits_btn_debug_printf_func debug_printf;
+#ifndef BITS_BTN_DISABLE_BUFFER
+    bits_btn_result_user_filter_callback result_user_filter_cb;
+#endif
+#ifdef BITS_BTN_USE_C11_BUFFER
+    bits_btn_ring_buffer_t ring_buffer;
+#endif
+#ifdef BITS_BTN_ENABLE_WAIT
+    bits_btn_atomic_uint_t wait_seq;                // Futex word, bumped when the tick wakes parked readers
+    bits_btn_atomic_uint_t wait_parked;             // Readers inside bits_button_wait_key_result_ctx()
+#endif
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+    pthread_t tick_thread;
+    uint8_t tick_thread_running;
+    int tick_timer_fd;
+    int tick_stop_fd;                               // eventfd that tells the thread to exit
+    uint64_t tick_period_ns;
+    uint64_t tick_start_ns;                         // CLOCK_MONOTONIC time the timer counts its expirations from
+    uint64_t tick_expirations;                      // Expirations handled since tick_start_ns
+    pthread_mutex_t tick_stats_lock;                // Guards tick_stats, lives as long as the instance
+    bits_btn_tick_thread_stats_t tick_stats;
+#endif
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    int event_fd;                                   // Valid while event_fd_open, kept across bits_button_init_ctx()
+    uint8_t event_fd_open;
+    bits_btn_atomic_uint_t event_fd_armed;          // Set once a reader found the ring empty, cleared by the signal
+#endif
 
     uint16_t combo_sorted_indices[BITS_BTN_MAX_COMBO_BUTTONS];
+    button_mask_type_t combo_anchor_sets[BITS_BTN_MAX_BUTTONS][BITS_BTN_COMBO_SET_WORDS];  // Combos whose lowest key is each single button
+    button_mask_type_t combo_busy_set[BITS_BTN_COMBO_SET_WORDS];  // Combos that are not idle
+#ifdef BITS_BTN_ENABLE_KEY_MAP
+    uint16_t key_index_map[BITS_BTN_KEY_MAP_SIZE];  // index + 1 into btns, then btns_combo; 0 = empty slot
+#endif
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+    bits_btn_tick_param_t tick_params[BITS_BTN_MAX_BUTTONS + BITS_BTN_MAX_COMBO_BUTTONS];  // Same indices as key_index_map
+#endif
+#ifdef BITS_BTN_ENABLE_PATTERNS
+    uint16_t pattern_roots[BITS_BTN_MAX_BUTTONS + BITS_BTN_MAX_COMBO_BUTTONS];  // Node + 1 of each key's pattern trie, 0 when it registered none
+    uint16_t pattern_node_cnt;
+    uint16_t pattern_nodes[BITS_BTN_MAX_PATTERN_NODES][2];  // Child node + 1 for bit 0 and bit 1, 0 = none
+#endif
+#ifdef BITS_BTN_ENABLE_HANDLERS
+    const bits_btn_handler_t *handlers;
+    uint8_t handlers_on_drain;                      // Handlers run from bits_button_dispatch_result_ctx() only
+    uint16_t handler_map[BITS_BTN_HANDLER_MAP_SIZE];  // index + 1 into handlers, 0 = empty slot
+#endif
+#ifdef BITS_BTN_USE_C11_BUFFER
+    bits_btn_atomic_size_t state_seq;               // Odd while a tick is updating the button states
+#else
+    volatile size_t state_seq;                      // Ordered by fences on GCC and Clang
+#endif
 } bits_button_t;
 
 // Buffer operation interface for unified buffer management
@@ -167,6 +695,7 @@ typedef struct
     size_t (*get_buffer_overwrite_count)(void);
     size_t (*get_buffer_capacity)(void);
     uint8_t (*peek)(bits_btn_result_t *result);
+    size_t (*read_batch)(bits_btn_result_t *out, size_t max);  // Optional: read up to max results, return the count
 } bits_btn_buffer_ops_t;
 
 typedef struct
@@ -178,6 +707,17 @@ typedef struct
     bits_btn_read_button_level read_button_level_func;
     bits_btn_result_callback bits_btn_result_cb;
     bits_btn_debug_printf_func bits_btn_debug_printf;
+    bits_btn_read_button_mask read_button_mask_func;    // Optional: raw level of btns[i] in bit i, used instead of read_button_level_func
+    bits_btn_debounce_mode_t debounce_mode;             // Optional: debounce strategy, BITS_BTN_DEBOUNCE_GLOBAL when zero
+    bits_btn_engine_t engine;                           // Optional: state machine engine, BITS_BTN_ENGINE_SWITCH when zero
+    const bits_btn_pattern_set_t *pattern_sets;         // Optional: key_values handled per key, lets those keys finish early (needs BITS_BTN_ENABLE_PATTERNS)
+    uint16_t pattern_sets_cnt;
+    const bits_btn_handler_t *handlers;                 // Optional: handlers looked up per result instead of switching in the callback (needs BITS_BTN_ENABLE_HANDLERS)
+    uint16_t handlers_cnt;
+    uint8_t handlers_on_drain;                          // Optional: 1 = handlers run from bits_button_dispatch_result() instead of during the tick
+    bits_btn_result_t *buffer_storage;                  // Optional: slots of the built-in C11 ring instead of its BITS_BTN_BUFFER_SIZE array (required with BITS_BTN_NO_BUILTIN_BUFFER)
+    size_t buffer_storage_size;                         // Slots in buffer_storage, at least 2 (a power of two with BITS_BTN_USE_POW2_BUFFER)
+    bits_btn_overflow_policy_t buffer_overflow_policy;  // Optional: full built-in ring behaviour, BITS_BTN_OVERFLOW_OVERWRITE_OLDEST when zero
 } bits_btn_config_t;
 
 /**
@@ -189,22 +729,97 @@ typedef struct
   * @retval bits_btn_error_t Status code indicating the result of the initialization:
   *         - BITS_BTN_OK (0): Success. All parameters are valid, and the button system is initialized.
   *         - BITS_BTN_ERR_INVALID_COMBO_ID (-1): Invalid key ID in combination button configuration.
-  *         - BITS_BTN_ERR_INVALID_PARAM (-2): Invalid input parameters (config/btns/read_func is NULL, etc.).
+  *         - BITS_BTN_ERR_INVALID_PARAM (-2): Invalid input parameters (config/btns is NULL, both read funcs are NULL, unknown debounce mode or engine,
+  *           BITS_BTN_ENGINE_SOA or BITS_BTN_ENGINE_WHEEL without its enable macro, unusable buffer_storage, unknown overflow policy, etc.).
   *         - BITS_BTN_ERR_TOO_MANY_COMBOS (-3): Too many combo buttons (exceeds BITS_BTN_MAX_COMBO_BUTTONS).
   *         - BITS_BTN_ERR_BUFFER_OPS_NULL (-4): User buffer mode requires setting buffer ops before init.
   *         - BITS_BTN_ERR_TOO_MANY_BUTTONS (-5): Too many buttons (exceeds BITS_BTN_MAX_BUTTONS).
   *         - BITS_BTN_ERR_BTN_PARAM_NULL (-6): A single button has NULL param pointer.
   *         - BITS_BTN_ERR_COMBO_PARAM_NULL (-7): A combo button has NULL param pointer.
   *         - BITS_BTN_ERR_COMBO_KEYS_INVALID (-8): Combo button keys config invalid (key_single_ids is NULL or key_count is 0).
+  *         - BITS_BTN_ERR_KEY_NOT_FOUND (-9): A pattern set or handler names an unknown key ID.
+  *         - BITS_BTN_ERR_PARAM_MISMATCH (-10): BITS_BTN_ENGINE_BITSLICE with single buttons using different params.
+  *         - BITS_BTN_ERR_TOO_MANY_PATTERNS (-11): The pattern sets need more than BITS_BTN_MAX_PATTERN_NODES trie nodes.
+  *         - BITS_BTN_ERR_TOO_MANY_HANDLERS (-12): More handlers than BITS_BTN_HANDLER_MAP_SIZE.
   */
 int32_t bits_button_init(const bits_btn_config_t *config);
 
+/**
+  * @brief  Release the default instance, see bits_button_deinit_ctx().
+  * @retval None
+  */
+void bits_button_deinit(void);
+
 /**
   * @brief  Background ticks function, called repeatedly by the timer with an interval of 5ms.
   * @retval None
   */
 void bits_button_ticks(void);
 
+/**
+  * @brief  Get the number of tick intervals until bits_button_ticks() has work to do.
+  *         Assumes the button inputs stay as they were at the last tick; any input
+  *         change must wake the host (e.g. through a GPIO edge interrupt).
+  * @retval 1 if the next regular tick is needed, N if the host may sleep for N tick
+  *         intervals and then call bits_button_ticks_elapsed(N), or
+  *         BITS_BTN_TICKS_INFINITE if every button is idle and the inputs are stable.
+  */
+uint32_t bits_button_get_next_deadline(void);
+
+/**
+  * @brief  Advance the engine by a number of elapsed tick intervals in one call.
+  *         Equivalent to calling bits_button_ticks() elapsed_ticks times, with the
+  *         inputs assumed unchanged until the last of them. The inputs are read once;
+  *         the engine jumps straight to the ticks where a threshold falls, so events
+  *         are generated on their correct logical tick (see bits_button_get_tick()).
+  *         Use it to catch up after a scheduler stall or a wake from sleep.
+  * @param  elapsed_ticks: Tick intervals elapsed since the last call to the ticks functions.
+  * @retval None
+  */
+void bits_button_ticks_elapsed(uint32_t elapsed_ticks);
+
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+/**
+  * @brief  Start a thread that runs the ticks from an absolute CLOCK_MONOTONIC timerfd.
+  *         The timer does not drift with the tick's run time; when the thread wakes a
+  *         period or more late it catches up with bits_button_ticks_elapsed().
+  *         Do not call the ticks functions yourself while it runs.
+  * @param  config: Period, CPU pinning and SCHED_FIFO priority; NULL for the defaults.
+  * @retval BITS_BTN_OK, BITS_BTN_ERR_INVALID_PARAM if already running or the options are
+  *         out of range, or BITS_BTN_ERR_SYSTEM (see errno, e.g. EPERM for SCHED_FIFO
+  *         without the privilege).
+  * @note   Only available when BITS_BTN_ENABLE_TICK_THREAD is defined (Linux).
+  *         Call it after bits_button_init() and stop it before initializing again;
+  *         init returns BITS_BTN_ERR_INVALID_PARAM while it runs.
+  */
+int32_t bits_button_start_tick_thread(const bits_btn_tick_thread_config_t *config);
+
+/**
+  * @brief  Stop the tick thread and wait for it to exit. Does nothing if it is not running.
+  * @retval BITS_BTN_OK
+  */
+int32_t bits_button_stop_tick_thread(void);
+
+/**
+  * @brief  Copy the timing statistics of the tick thread, optionally resetting them.
+  *         They are kept after the thread stops and cleared when it starts.
+  *         Safe to call from any thread, also while the thread starts or stops, but not
+  *         concurrently with bits_button_init() or bits_button_deinit(), which replace
+  *         the lock guarding them.
+  * @param  stats: Receives the snapshot, may be NULL when only resetting.
+  * @param  reset: 1 to zero the statistics after copying them.
+  * @retval None
+  */
+void bits_button_get_tick_thread_stats(bits_btn_tick_thread_stats_t *stats, uint8_t reset);
+#endif
+
+/**
+  * @brief  Get the logical tick of the engine.
+  *         Inside the result callback this is the tick the event was generated on.
+  * @retval Number of ticks processed since initialization.
+  */
+uint32_t bits_button_get_tick(void);
+
 /**
   * @brief  Get the button key result from the buffer.
   * @param  result: Pointer to store the button key result
@@ -212,6 +827,16 @@ void bits_button_ticks(void);
   */
 uint8_t bits_button_get_key_result(bits_btn_result_t *result);
 
+/**
+  * @brief  Get up to max button key results from the buffer in one call.
+  *         Cheaper than calling bits_button_get_key_result() per event when
+  *         draining bursts: the read index is published once for the whole run.
+  * @param  out: Array receiving the results, oldest first.
+  * @param  max: Capacity of out.
+  * @retval Number of results read, 0 if the buffer is empty or out is NULL.
+  */
+size_t bits_button_get_key_results(bits_btn_result_t *out, size_t max);
+
 /**
  * @brief  Peek the button key result from the buffer without removing it.
  * @param  result: Pointer to store the button key result
@@ -219,6 +844,81 @@ uint8_t bits_button_get_key_result(bits_btn_result_t *result);
  */
 uint8_t bits_button_peek_key_result(bits_btn_result_t *result);
 
+#ifdef BITS_BTN_ENABLE_WAIT
+// timeout_ms of bits_button_wait_key_result() that never times out
+#define BITS_BTN_WAIT_FOREVER       UINT32_MAX
+
+/**
+  * @brief  Get the button key result from the buffer, blocking while it is empty.
+  *         The reader sleeps on a futex; the tick only makes the wake-up system call
+  *         while a reader is parked, so the non-blocking path stays lock-free.
+  * @param  result: Pointer to store the button key result
+  * @param  timeout_ms: Longest time to wait, 0 to only try, or BITS_BTN_WAIT_FOREVER.
+  * @retval true(1) if a result was read, false if the timeout expired first.
+  * @note   Only available when BITS_BTN_ENABLE_WAIT is defined (Linux, default buffer mode).
+  */
+uint8_t bits_button_wait_key_result(bits_btn_result_t *result, uint32_t timeout_ms);
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENTFD
+/**
+  * @brief  Get a file descriptor that becomes readable when results arrive, for epoll/poll.
+  *         It turns readable when the ring goes from empty to non-empty; drain the ring
+  *         with bits_button_get_key_result() until it returns 0, which also resets the
+  *         descriptor. Do not read() it yourself.
+  * @retval Nonblocking eventfd, created on the first call and kept across
+  *         bits_button_init() until bits_button_close_event_fd() or bits_button_deinit();
+  *         -1 if it cannot be created (see errno).
+  * @note   Only available when BITS_BTN_ENABLE_EVENTFD is defined (Linux, default buffer mode).
+  *         Create it before the tick starts running in another thread.
+  */
+int bits_button_get_event_fd(void);
+
+/**
+  * @brief  Close the descriptor returned by bits_button_get_event_fd().
+  *         Must not run concurrently with the tick.
+  * @retval None
+  */
+void bits_button_close_event_fd(void);
+#endif
+
+#if defined(BITS_BTN_ENABLE_EVENT_TIMESTAMPS) && !defined(BITS_BTN_DISABLE_BUFFER)
+/**
+  * @brief  Get how long the oldest unread result has been waiting in the buffer.
+  * @retval Ticks since the oldest buffered result was reported, 0 if the buffer is empty.
+  *         Measured against the tick counter the ticks publish, so it may be called from
+  *         the thread reading the buffer while another thread runs the ticks.
+  * @note   Only available when BITS_BTN_ENABLE_EVENT_TIMESTAMPS is defined.
+  */
+uint32_t bits_button_get_queue_age(void);
+#endif
+
+#ifdef BITS_BTN_ENABLE_STATS
+/**
+  * @brief  Copy the event pipeline statistics, optionally resetting them.
+  *         Counters are read one by one without stopping the tick or the reader,
+  *         so a snapshot taken while events flow may be off by the events in flight.
+  * @param  stats: Receives the snapshot, may be NULL when only resetting.
+  * @param  reset: 1 to zero every counter as it is read; no event is lost between
+  *         two resetting snapshots, which makes periodic scraping return deltas.
+  * @retval None
+  * @note   Only available when BITS_BTN_ENABLE_STATS is defined.
+  */
+void bits_button_get_stats(bits_btn_stats_t *stats, uint8_t reset);
+#endif
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+/**
+  * @brief  Run the registered handler matching a result, see bits_btn_config_t::handlers.
+  *         With handlers_on_drain set, call it for each result read from the buffer;
+  *         otherwise the engine already calls it for every event during the tick.
+  * @param  result: Result to dispatch.
+  * @retval 1 if a handler ran, 0 if none matches or result is NULL.
+  * @note   Only available when BITS_BTN_ENABLE_HANDLERS is defined.
+  */
+uint8_t bits_button_dispatch_result(const bits_btn_result_t *result);
+#endif
+
 /**
   * @brief  Reset all button states to idle.
   *         This function should be called when resuming from low power mode
@@ -269,9 +969,9 @@ void bits_button_set_buffer_ops(const bits_btn_buffer_ops_t *user_buffer_ops);
   * @brief  Get the usable capacity of the button result buffer.
   *         This function returns the maximum number of button events that
   *         can be stored in the buffer.
-  * @note   The underlying array size is capacity + 1 due to ring buffer
-  *         implementation requirements (one slot reserved to distinguish
-  *         full/empty states).
+  * @note   The built-in ring keeps one slot free to tell full from empty,
+  *         so its capacity is one less than its number of slots; with
+  *         BITS_BTN_USE_POW2_BUFFER every slot is usable.
   * @retval The usable buffer capacity in number of elements. Returns 0 if buffer is disabled.
   */
 size_t get_bits_btn_buffer_capacity(void);
@@ -286,6 +986,192 @@ size_t get_bits_btn_buffer_capacity(void);
   */
 void bits_btn_register_result_filter_callback(bits_btn_result_user_filter_callback cb);
 
+/**
+  * @brief  Get a consistent snapshot of a single or combo key's state.
+  *         Safe to call from another thread or from the main loop while the ticks
+  *         run in an interrupt: the read is retried if a tick updates the states meanwhile.
+  *         Without the C11 ring the retry relies on GCC/Clang fences; other
+  *         compilers must define BITS_BTN_STATE_FENCE() as a memory barrier.
+  *         Single keys suppressed by an active combo report the idle state.
+  * @param  key_id: Key ID of a single or combo button.
+  * @param  state: Pointer to store the snapshot.
+  * @retval BITS_BTN_OK, BITS_BTN_ERR_INVALID_PARAM if state is NULL, or
+  *         BITS_BTN_ERR_KEY_NOT_FOUND if no button has this key ID.
+  */
+int32_t bits_button_get_key_state(uint16_t key_id, bits_btn_key_state_t *state);
+
+/**
+  * @brief  Check whether a key is held right now (pressed or long press state).
+  * @retval 1 if held, 0 if not held or the key ID is unknown.
+  */
+uint8_t bits_button_is_key_held(uint16_t key_id);
+
+/**
+  * @brief  Get how long a key has been held.
+  * @retval Ticks since the current press started, 0 if not held or the key ID is unknown.
+  */
+uint32_t bits_button_get_key_held_ticks(uint16_t key_id);
+
+/**
+  * @brief  Get the number of presses in a key's current click sequence.
+  * @retval Click count, 0 if the key is idle or the key ID is unknown.
+  */
+uint8_t bits_button_get_key_click_count(uint16_t key_id);
+
+/**
+  * @brief  Get the sequence bits a key has recorded so far.
+  * @retval Current state_bits, 0 if the key is idle or the key ID is unknown.
+  */
+state_bits_type_t bits_button_get_key_state_bits(uint16_t key_id);
+
+/*
+ * Multi-instance API
+ *
+ * The functions above operate on a built-in default instance. The *_ctx
+ * variants below take an explicit bits_button_t so that independent button
+ * banks can coexist and be ticked from separate threads. Each instance must
+ * only be ticked by one thread at a time; in the default buffer mode every
+ * instance has its own SPSC result ring. In BITS_BTN_USE_USER_BUFFER mode all
+ * instances share the buffer ops registered with bits_button_set_buffer_ops().
+ */
+
+/**
+  * @brief  Initialize a button engine instance. See bits_button_init() for return codes.
+  * @param  button: Instance to initialize (caller-owned storage). Before its first init
+  *                 the storage must be zero-filled (static storage, calloc() or memset()),
+  *                 otherwise BITS_BTN_ERR_INVALID_PARAM is returned. Only a result filter
+  *                 may be registered on it before then. Initializing it again keeps its
+  *                 result filter and its eventfd.
+  * @param  config: Pointer to the configuration structure.
+  */
+int32_t bits_button_init_ctx(bits_button_t *button, const bits_btn_config_t *config);
+
+/**
+  * @brief  Release an instance: stop its tick thread, destroy its tick stats lock, close
+  *         its eventfd and zero-fill it, so the storage can be freed or initialized as new
+  *         storage. Does nothing if it is not initialized.
+  * @param  button: Instance to release.
+  * @retval None
+  */
+void bits_button_deinit_ctx(bits_button_t *button);
+
+/**
+  * @brief  Background ticks function for an instance.
+  * @param  button: Instance to tick.
+  * @retval None
+  */
+void bits_button_ticks_ctx(bits_button_t *button);
+
+/**
+  * @brief  Get the number of tick intervals until an instance has work to do.
+  *         See bits_button_get_next_deadline().
+  */
+uint32_t bits_button_get_next_deadline_ctx(bits_button_t *button);
+
+/**
+  * @brief  Advance an instance by a number of elapsed tick intervals.
+  *         See bits_button_ticks_elapsed().
+  */
+void bits_button_ticks_elapsed_ctx(bits_button_t *button, uint32_t elapsed_ticks);
+
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+/**
+  * @brief  Tick thread of an instance. See bits_button_start_tick_thread().
+  */
+int32_t bits_button_start_tick_thread_ctx(bits_button_t *button, const bits_btn_tick_thread_config_t *config);
+int32_t bits_button_stop_tick_thread_ctx(bits_button_t *button);
+void bits_button_get_tick_thread_stats_ctx(bits_button_t *button, bits_btn_tick_thread_stats_t *stats, uint8_t reset);
+#endif
+
+/**
+  * @brief  Get the logical tick of an instance. See bits_button_get_tick().
+  */
+uint32_t bits_button_get_tick_ctx(bits_button_t *button);
+
+/**
+  * @brief  Get the button key result from an instance's buffer.
+  * @retval true(1) if read successfully, false if the buffer is empty.
+  */
+uint8_t bits_button_get_key_result_ctx(bits_button_t *button, bits_btn_result_t *result);
+
+/**
+  * @brief  Get up to max button key results from an instance's buffer. See bits_button_get_key_results().
+  * @retval Number of results read, 0 if the buffer is empty or out is NULL.
+  */
+size_t bits_button_get_key_results_ctx(bits_button_t *button, bits_btn_result_t *out, size_t max);
+
+/**
+  * @brief  Peek the button key result from an instance's buffer without removing it.
+  * @retval true(1) if peek successfully, false if the buffer is empty.
+  */
+uint8_t bits_button_peek_key_result_ctx(bits_button_t *button, bits_btn_result_t *result);
+
+#ifdef BITS_BTN_ENABLE_WAIT
+/**
+  * @brief  Get the button key result from an instance's buffer, blocking while it is empty.
+  *         See bits_button_wait_key_result().
+  */
+uint8_t bits_button_wait_key_result_ctx(bits_button_t *button, bits_btn_result_t *result, uint32_t timeout_ms);
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENTFD
+/**
+  * @brief  Readiness descriptor of an instance. See bits_button_get_event_fd().
+  */
+int bits_button_get_event_fd_ctx(bits_button_t *button);
+void bits_button_close_event_fd_ctx(bits_button_t *button);
+#endif
+
+#if defined(BITS_BTN_ENABLE_EVENT_TIMESTAMPS) && !defined(BITS_BTN_DISABLE_BUFFER)
+/**
+  * @brief  Get how long the oldest unread result of an instance has been waiting. See bits_button_get_queue_age().
+  */
+uint32_t bits_button_get_queue_age_ctx(bits_button_t *button);
+#endif
+
+#ifdef BITS_BTN_ENABLE_STATS
+/**
+  * @brief  Copy the event pipeline statistics of an instance. See bits_button_get_stats().
+  */
+void bits_button_get_stats_ctx(bits_button_t *button, bits_btn_stats_t *stats, uint8_t reset);
+#endif
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+/**
+  * @brief  Run the handler of an instance matching a result. See bits_button_dispatch_result().
+  * @retval 1 if a handler ran, 0 if none matches or result is NULL.
+  */
+uint8_t bits_button_dispatch_result_ctx(bits_button_t *button, const bits_btn_result_t *result);
+#endif
+
+/**
+  * @brief  Reset all button states of an instance to idle.
+  * @retval None
+  */
+void bits_button_reset_states_ctx(bits_button_t *button);
+
+size_t get_bits_btn_buffer_overwrite_count_ctx(bits_button_t *button);
+size_t get_bits_btn_buffer_used_count_ctx(bits_button_t *button);
+uint8_t bits_btn_is_buffer_full_ctx(bits_button_t *button);
+uint8_t bits_btn_is_buffer_empty_ctx(bits_button_t *button);
+size_t get_bits_btn_buffer_capacity_ctx(bits_button_t *button);
+
+/**
+  * @brief  Register a result filter callback for an instance.
+  *         May be called before or after bits_button_init_ctx().
+  * @retval None
+  */
+void bits_btn_register_result_filter_callback_ctx(bits_button_t *button, bits_btn_result_user_filter_callback cb);
+
+/**
+  * @brief  Per-key state queries for an instance. See bits_button_get_key_state().
+  */
+int32_t bits_button_get_key_state_ctx(bits_button_t *button, uint16_t key_id, bits_btn_key_state_t *state);
+uint8_t bits_button_is_key_held_ctx(bits_button_t *button, uint16_t key_id);
+uint32_t bits_button_get_key_held_ticks_ctx(bits_button_t *button, uint16_t key_id);
+uint8_t bits_button_get_key_click_count_ctx(bits_button_t *button, uint16_t key_id);
+state_bits_type_t bits_button_get_key_state_bits_ctx(bits_button_t *button, uint16_t key_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -374,4 +374,298 @@ void test_buffer_overwrite_count_accuracy(void) {
     
     printf("覆写计数准确性测试通过: 额外写入 %zu 次, 覆写计数增加 %zu\n",
            extra_writes, actual_overwrites);
-}
\ No newline at end of file
+}
+void test_buffer_batch_read(void) {
+    printf("\n=== 测试批量读取缓冲区 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[10];
+    for (int i = 0; i < 10; i++) {
+        buttons[i] = (button_obj_t)BITS_BUTTON_INIT(i + 1, 1, &param);
+    }
+
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = 10,
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .bits_btn_debug_printf = test_framework_log_printf
+    };
+    bits_button_init(&config);
+
+    size_t capacity = get_bits_btn_buffer_capacity();
+    bits_btn_result_t out[64];
+    TEST_ASSERT_TRUE(capacity <= ARRAY_SIZE(out));
+    TEST_ASSERT_EQUAL_size_t(0, bits_button_get_key_results(out, ARRAY_SIZE(out)));
+    TEST_ASSERT_EQUAL_size_t(0, bits_button_get_key_results(NULL, ARRAY_SIZE(out)));
+
+    // 写入 capacity + 3 个事件，读索引回绕，保留的事件跨越数组末尾
+    const size_t writes = capacity + 3;
+    for (size_t i = 0; i < writes; i++) {
+        mock_button_click((uint8_t)(i % 10 + 1), STANDARD_CLICK_TIME_MS);
+        time_simulate_time_window_end();
+        bits_button_ticks();
+    }
+
+    // 分两批读完，顺序与写入一致，从第一个未被覆盖的事件开始
+    size_t first = bits_button_get_key_results(out, 4);
+    TEST_ASSERT_EQUAL_size_t(4, first);
+    size_t rest = bits_button_get_key_results(out + first, ARRAY_SIZE(out) - first);
+    TEST_ASSERT_EQUAL_size_t(capacity - 4, rest);
+    for (size_t i = 0; i < capacity; i++) {
+        TEST_ASSERT_EQUAL_UINT16((i + 3) % 10 + 1, out[i].key_id);
+        TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, out[i].event);
+    }
+    TEST_ASSERT_TRUE(bits_btn_is_buffer_empty());
+    TEST_ASSERT_EQUAL_size_t(0, bits_button_get_key_results(out, 0));
+
+    printf("批量读取缓冲区测试通过: 读取 %zu 个事件\n", first + rest);
+}
+
+// ==================== 溢出策略测试 ====================
+
+static bits_btn_result_t policy_storage[4];
+
+static void policy_init(button_obj_t *buttons, uint16_t cnt, bits_btn_overflow_policy_t policy) {
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = cnt,
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .buffer_storage = policy_storage,
+        .buffer_storage_size = ARRAY_SIZE(policy_storage),
+        .buffer_overflow_policy = policy
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+void test_buffer_overflow_policy_drop_newest(void) {
+    printf("\n=== 测试溢出策略: 丢弃最新事件 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param)
+    };
+    policy_init(buttons, ARRAY_SIZE(buttons), BITS_BTN_OVERFLOW_DROP_NEWEST);
+
+    size_t capacity = get_bits_btn_buffer_capacity();
+    for (size_t i = 0; i < capacity + 2; i++) {
+        mock_button_click(i < capacity ? 1 : 2, STANDARD_CLICK_TIME_MS);
+        time_simulate_time_window_end();
+    }
+
+    // 先入队的事件保留，满了之后的事件被丢弃并计数
+    TEST_ASSERT_EQUAL(2, get_bits_btn_buffer_overwrite_count());
+    bits_btn_result_t result;
+    size_t read = 0;
+    while (bits_button_get_key_result(&result)) {
+        TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+        read++;
+    }
+    TEST_ASSERT_EQUAL(capacity, read);
+
+    printf("丢弃最新事件策略测试通过\n");
+}
+
+void test_buffer_overflow_policy_coalesce(void) {
+    printf("\n=== 测试溢出策略: 合并长按重复事件 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param)
+    };
+    policy_init(buttons, ARRAY_SIZE(buttons), BITS_BTN_OVERFLOW_COALESCE);
+    size_t capacity = get_bits_btn_buffer_capacity();
+
+    // 按键2的FINISH先入队，随后按键1长按产生一串重复事件，消费者一直没有读取
+    mock_button_click(2, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    mock_button_press(1);
+    time_simulate_debounce_delay();
+    time_simulate_long_press_threshold();
+    time_simulate_pass(BITS_BTN_LONG_PRESS_PERIOD_TRIGER_MS * (capacity + 4));
+
+    // 回调收到了全部重复事件，记下数量和最后一次的触发计数
+    const bits_btn_result_t *events = test_framework_get_events();
+    size_t repeats = 0;
+    uint16_t last_cnt = 0;
+    for (int i = 0; i < test_framework_get_event_count(); i++) {
+        if (events[i].key_id == 1 && events[i].event == BTN_EVENT_LONG_PRESS) {
+            repeats++;
+            last_cnt = events[i].long_press_period_trigger_cnt;
+        }
+    }
+    TEST_ASSERT_TRUE(repeats > capacity);
+    TEST_ASSERT_EQUAL(capacity, get_bits_btn_buffer_used_count());
+    TEST_ASSERT_EQUAL(repeats - capacity, get_bits_btn_buffer_overwrite_count());
+
+    // 终结事件没有被长按重复挤掉
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(2, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, result.event);
+    while (bits_button_get_key_result(&result)) {
+    }
+
+    // 腾出空间后，下一个tick补发被合并的事件，带着最新的触发计数
+    time_simulate_ticks(1);
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_LONG_PRESS, result.event);
+    TEST_ASSERT_EQUAL_UINT16(last_cnt, result.long_press_period_trigger_cnt);
+
+    mock_button_release(1);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, result.event);
+
+    printf("合并长按重复事件策略测试通过: %zu 个重复事件, 合并 %zu 个\n", repeats, repeats - capacity);
+}
+
+// 回调记录中某个按键的长按重复次数
+static size_t policy_repeat_count(uint16_t key_id, uint16_t *last_cnt) {
+    const bits_btn_result_t *events = test_framework_get_events();
+    size_t repeats = 0;
+    for (int i = 0; i < test_framework_get_event_count(); i++) {
+        if (events[i].key_id == key_id && events[i].event == BTN_EVENT_LONG_PRESS
+            && events[i].long_press_period_trigger_cnt != 0) {
+            repeats++;
+            if (last_cnt) {
+                *last_cnt = events[i].long_press_period_trigger_cnt;
+            }
+        }
+    }
+    return repeats;
+}
+
+void test_buffer_overflow_policy_coalesce_terminal(void) {
+    printf("\n=== 测试溢出策略: 合并时保留终结事件 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param),
+        BITS_BUTTON_INIT(3, 1, &param)
+    };
+    policy_init(buttons, ARRAY_SIZE(buttons), BITS_BTN_OVERFLOW_COALESCE);
+    size_t capacity = get_bits_btn_buffer_capacity();
+    TEST_ASSERT_TRUE(capacity >= 3);
+
+    // 按键1长按开始、恰好一次重复、FINISH，再用按键2的FINISH填满缓冲区
+    mock_button_press(1);
+    time_simulate_debounce_delay();
+    time_simulate_long_press_threshold();
+    while (policy_repeat_count(1, NULL) == 0) {
+        time_simulate_ticks(1);
+    }
+    mock_button_release(1);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    size_t fill = 0;
+    while (get_bits_btn_buffer_used_count() < capacity) {
+        mock_button_click(2, STANDARD_CLICK_TIME_MS);
+        time_simulate_time_window_end();
+        fill++;
+    }
+    TEST_ASSERT_EQUAL(capacity - 3, fill);
+
+    // 第一个溢出的事件被扣下；第二个挤掉队列里的重复事件；此后全是终结事件，最新的被拒绝
+    mock_button_click(3, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL(0, get_bits_btn_buffer_overwrite_count());
+    mock_button_click(2, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL(1, get_bits_btn_buffer_overwrite_count());
+    mock_button_click(3, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL(2, get_bits_btn_buffer_overwrite_count());
+    TEST_ASSERT_EQUAL(capacity, get_bits_btn_buffer_used_count());
+
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_LONG_PRESS, result.event);
+    TEST_ASSERT_EQUAL_UINT16(0, result.long_press_period_trigger_cnt);
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, result.event);
+    for (size_t i = 0; i < fill; i++) {
+        TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+        TEST_ASSERT_EQUAL_UINT16(2, result.key_id);
+        TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, result.event);
+    }
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(3, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, result.event);
+    TEST_ASSERT_FALSE(bits_button_get_key_result(&result));
+
+    // 扣下的按键2事件在下一个tick补发，被拒绝的按键3事件不再出现
+    time_simulate_ticks(1);
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT16(2, result.key_id);
+    TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_FINISH, result.event);
+    TEST_ASSERT_FALSE(bits_button_get_key_result(&result));
+
+    printf("合并时保留终结事件测试通过\n");
+}
+
+void test_buffer_overflow_policy_coalesce_two_keys(void) {
+    printf("\n=== 测试溢出策略: 两个按键交替的长按重复 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param)
+    };
+    policy_init(buttons, ARRAY_SIZE(buttons), BITS_BTN_OVERFLOW_COALESCE);
+    size_t capacity = get_bits_btn_buffer_capacity();
+
+    // 两个按键同时长按，重复事件在同一个tick内交替产生
+    mock_button_press(1);
+    mock_button_press(2);
+    time_simulate_debounce_delay();
+    time_simulate_long_press_threshold();
+    time_simulate_pass(BITS_BTN_LONG_PRESS_PERIOD_TRIGER_MS * (capacity + 4));
+
+    uint16_t last_cnt[2] = {0, 0};
+    size_t repeats = policy_repeat_count(1, &last_cnt[0]) + policy_repeat_count(2, &last_cnt[1]);
+    TEST_ASSERT_TRUE(repeats > capacity);
+
+    // 读空缓冲区并补发扣下的事件
+    bits_btn_result_t result;
+    uint8_t started[2] = {0, 0};
+    uint16_t max_cnt[2] = {0, 0};
+    size_t read = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        while (bits_button_get_key_result(&result)) {
+            TEST_ASSERT_TRUE(result.key_id == 1 || result.key_id == 2);
+            TEST_ASSERT_EQUAL_UINT8(BTN_EVENT_LONG_PRESS, result.event);
+            if (result.long_press_period_trigger_cnt == 0) {
+                started[result.key_id - 1] = 1;
+            } else if (result.long_press_period_trigger_cnt > max_cnt[result.key_id - 1]) {
+                max_cnt[result.key_id - 1] = result.long_press_period_trigger_cnt;
+            }
+            read++;
+        }
+        time_simulate_ticks(1);
+    }
+
+    // 长按开始都保留，重复事件不跨按键合并：每个按键最新的触发计数都送达
+    TEST_ASSERT_TRUE(started[0] && started[1]);
+    TEST_ASSERT_EQUAL_UINT16(last_cnt[0], max_cnt[0]);
+    TEST_ASSERT_EQUAL_UINT16(last_cnt[1], max_cnt[1]);
+    TEST_ASSERT_EQUAL(repeats + 2 - read, get_bits_btn_buffer_overwrite_count());
+
+    mock_button_release(1);
+    mock_button_release(2);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    while (bits_button_get_key_result(&result)) {
+    }
+
+    printf("两个按键交替的长按重复测试通过: %zu 个重复事件, 读到 %zu 个\n", repeats, read);
+}
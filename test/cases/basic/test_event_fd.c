@@ -0,0 +1,144 @@
+/* test_event_fd.c - 可轮询事件描述符测试 */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#ifdef BITS_BTN_ENABLE_EVENTFD
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+// ==================== 辅助函数 ====================
+
+static uint8_t fd_readable(int fd) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+static void event_fd_init(void) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t buttons[2];
+    buttons[0] = (button_obj_t)BITS_BUTTON_INIT(1, 1, &param);
+    buttons[1] = (button_obj_t)BITS_BUTTON_INIT(2, 1, &param);
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+// ==================== 描述符就绪测试 ====================
+
+void test_event_fd_readiness(void) {
+    printf("\n=== 测试事件描述符就绪状态 ===\n");
+
+    event_fd_init();
+    int fd = bits_button_get_event_fd();
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(fd, bits_button_get_event_fd());
+    TEST_ASSERT_FALSE(fd_readable(fd));
+
+    // 缓冲区由空变为非空时可读，继续写入不会重复通知
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    mock_button_click(2, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_TRUE(fd_readable(fd));
+    uint64_t count = 0;
+    TEST_ASSERT_EQUAL(sizeof(count), read(fd, &count, sizeof(count)));
+    TEST_ASSERT_EQUAL_UINT64(1, count);
+    TEST_ASSERT_EQUAL(sizeof(count), write(fd, &count, sizeof(count)));
+
+    // 读到缓冲区为空之后不再可读
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_TRUE(fd_readable(fd));
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_FALSE(bits_button_get_key_result(&result));
+    TEST_ASSERT_FALSE(fd_readable(fd));
+
+    // 下一次由空变为非空再次可读；重新初始化保留描述符，未读事件随缓冲区清空
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_TRUE(fd_readable(fd));
+    event_fd_init();
+    TEST_ASSERT_EQUAL_INT(fd, bits_button_get_event_fd());
+    TEST_ASSERT_FALSE(fd_readable(fd));
+
+    // 描述符创建时缓冲区已有事件则立即可读
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    bits_button_close_event_fd();
+    fd = bits_button_get_event_fd();
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_TRUE(fd_readable(fd));
+    while (bits_button_get_key_result(&result)) {
+    }
+
+    // deinit关闭描述符，之后可以重新初始化
+    bits_button_deinit();
+    TEST_ASSERT_EQUAL_INT(-1, fcntl(fd, F_GETFD));
+    event_fd_init();
+
+    printf("事件描述符就绪状态测试通过\n");
+}
+
+static int epoll_fd;
+static bits_btn_result_t epoll_results[4];
+static int epoll_result_cnt;
+
+// 典型的epoll事件循环：等待描述符可读，然后读空缓冲区
+static void *epoll_thread(void *arg) {
+    (void)arg;
+    struct epoll_event ev;
+    while (epoll_result_cnt < 2 && epoll_wait(epoll_fd, &ev, 1, 2000) == 1) {
+        bits_btn_result_t result;
+        while (bits_button_get_key_result(&result)) {
+            epoll_results[epoll_result_cnt++] = result;
+        }
+    }
+    return NULL;
+}
+
+void test_event_fd_epoll_loop(void) {
+    printf("\n=== 测试事件描述符接入epoll ===\n");
+
+    event_fd_init();
+    int fd = bits_button_get_event_fd();
+    TEST_ASSERT_TRUE(fd >= 0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    TEST_ASSERT_TRUE(epoll_fd >= 0);
+    struct epoll_event ev = {.events = EPOLLIN, .data.fd = fd};
+    TEST_ASSERT_EQUAL(0, epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev));
+    epoll_result_cnt = 0;
+
+    pthread_t loop;
+    TEST_ASSERT_EQUAL(0, pthread_create(&loop, NULL, epoll_thread, NULL));
+
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    mock_button_click(2, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    pthread_join(loop, NULL);
+
+    TEST_ASSERT_EQUAL_INT(2, epoll_result_cnt);
+    TEST_ASSERT_EQUAL_UINT16(1, epoll_results[0].key_id);
+    TEST_ASSERT_EQUAL_UINT16(2, epoll_results[1].key_id);
+
+    close(epoll_fd);
+    bits_button_close_event_fd();
+
+    printf("事件描述符接入epoll测试通过\n");
+}
+
+#endif
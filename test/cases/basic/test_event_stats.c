@@ -0,0 +1,172 @@
+/* test_event_stats.c - 事件管线统计测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#if defined(BITS_BTN_ENABLE_STATS) && !defined(BITS_BTN_DISABLE_BUFFER)
+
+// ==================== 辅助函数 ====================
+
+// 与库内的分桶规则一致：0单独一桶，其余按二进制位数分桶
+static size_t expected_bucket(uint32_t ticks) {
+    size_t bucket = 0;
+    while (ticks && bucket < BITS_BTN_STATS_BUCKETS - 1) {
+        bucket++;
+        ticks >>= 1;
+    }
+    return bucket;
+}
+
+static size_t histogram_total(const size_t *histogram) {
+    size_t total = 0;
+    for (size_t b = 0; b < BITS_BTN_STATS_BUCKETS; b++) {
+        total += histogram[b];
+    }
+    return total;
+}
+
+static void stats_init(void) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t buttons[2];
+    buttons[0] = (button_obj_t)BITS_BUTTON_INIT(1, 1, &param);
+    buttons[1] = (button_obj_t)BITS_BUTTON_INIT(2, 1, &param);
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+// ==================== 统计测试 ====================
+
+void test_event_stats_histograms(void) {
+    printf("\n=== 测试事件管线统计直方图 ===\n");
+
+    stats_init();
+    bits_btn_stats_t stats;
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(0, stats.reported);
+
+    // 单击上报按下、松开、结束三个事件，默认过滤器只把结束事件写入缓冲区
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    bits_btn_result_t finish;
+    TEST_ASSERT_TRUE(bits_button_peek_key_result(&finish));
+
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(3, stats.reported);
+    TEST_ASSERT_EQUAL_size_t(1, stats.buffered);
+    TEST_ASSERT_EQUAL_size_t(0, stats.dequeued);
+    TEST_ASSERT_EQUAL_size_t(1, stats.occupancy_high_watermark);
+    TEST_ASSERT_EQUAL_size_t(1, stats.report_latency[BTN_EVENT_PRESSED][0]);
+    TEST_ASSERT_EQUAL_size_t(1, histogram_total(stats.report_latency[BTN_EVENT_RELEASE]));
+    TEST_ASSERT_EQUAL_size_t(1, stats.report_latency[BTN_EVENT_FINISH]
+                                 [expected_bucket(finish.report_tick - finish.accept_tick)]);
+    TEST_ASSERT_EQUAL_size_t(1, histogram_total(stats.report_latency[BTN_EVENT_FINISH]));
+    TEST_ASSERT_EQUAL_size_t(0, histogram_total(stats.queue_latency));
+
+    // 读取时按等待的tick数记入排队延迟直方图
+    time_simulate_ticks(20);
+    uint32_t waited = bits_button_get_tick() - finish.report_tick;
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(1, stats.dequeued);
+    TEST_ASSERT_EQUAL_size_t(1, stats.queue_latency[expected_bucket(waited)]);
+
+    // 批量读取同样计入
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    mock_button_click(2, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    bits_btn_result_t batch[4];
+    TEST_ASSERT_EQUAL_size_t(2, bits_button_get_key_results(batch, ARRAY_SIZE(batch)));
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(3, stats.buffered);
+    TEST_ASSERT_EQUAL_size_t(3, stats.dequeued);
+    TEST_ASSERT_EQUAL_size_t(3, histogram_total(stats.queue_latency));
+    TEST_ASSERT_EQUAL_size_t(2, stats.occupancy_high_watermark);
+
+    printf("事件管线统计直方图测试通过\n");
+}
+
+void test_event_stats_reset(void) {
+    printf("\n=== 测试事件管线统计重置 ===\n");
+
+    stats_init();
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+
+    // 带重置的快照返回累计值并清零，下一次只看到之后的增量
+    bits_btn_stats_t stats;
+    bits_button_get_stats(&stats, 1);
+    TEST_ASSERT_EQUAL_size_t(3, stats.reported);
+    TEST_ASSERT_EQUAL_size_t(1, stats.occupancy_high_watermark);
+
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(0, stats.reported);
+    TEST_ASSERT_EQUAL_size_t(0, stats.buffered);
+    TEST_ASSERT_EQUAL_size_t(0, stats.occupancy_high_watermark);
+    TEST_ASSERT_EQUAL_size_t(0, histogram_total(stats.report_latency[BTN_EVENT_FINISH]));
+
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    bits_button_get_stats(NULL, 1);
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(0, stats.dequeued);
+
+    printf("事件管线统计重置测试通过\n");
+}
+
+#ifdef BITS_BTN_USE_C11_BUFFER
+void test_event_stats_coalesce_held(void) {
+    printf("\n=== 测试合并策略下暂存事件的统计 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t buttons[1];
+    static bits_btn_result_t storage[2];
+    buttons[0] = (button_obj_t)BITS_BUTTON_INIT(1, 1, &param);
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .buffer_storage = storage,
+        .buffer_storage_size = ARRAY_SIZE(storage),
+        .buffer_overflow_policy = BITS_BTN_OVERFLOW_COALESCE
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+    size_t capacity = get_bits_btn_buffer_capacity();
+
+    // 填满缓冲区后再多一个事件，它被暂存而不计入已写入
+    for (size_t i = 0; i <= capacity; i++) {
+        mock_button_click(1, STANDARD_CLICK_TIME_MS);
+        time_simulate_time_window_end();
+    }
+    bits_btn_stats_t stats;
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(capacity, stats.buffered);
+    TEST_ASSERT_EQUAL_size_t(capacity, stats.occupancy_high_watermark);
+
+    // 读出一个后，下一个tick把暂存的事件写入缓冲区，此时才计入
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    time_simulate_ticks(1);
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(capacity + 1, stats.buffered);
+    TEST_ASSERT_EQUAL_size_t(capacity, get_bits_btn_buffer_used_count());
+    while (bits_button_get_key_result(&result)) {
+    }
+    bits_button_get_stats(&stats, 0);
+    TEST_ASSERT_EQUAL_size_t(stats.buffered, stats.dequeued);
+
+    printf("合并策略下暂存事件的统计测试通过\n");
+}
+#endif
+
+#endif
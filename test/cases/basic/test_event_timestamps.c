@@ -0,0 +1,149 @@
+/* test_event_timestamps.c - 事件时间戳与队列延迟测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+
+// ==================== 辅助函数 ====================
+
+static const bits_btn_result_t *find_event(uint16_t key_id, uint8_t event) {
+    const bits_btn_result_t *events = test_framework_get_events();
+    const bits_btn_result_t *found = NULL;
+    for (int i = 0; i < test_framework_get_event_count(); i++) {
+        if (events[i].key_id == key_id && events[i].event == event) {
+            found = &events[i];
+        }
+    }
+    return found;
+}
+
+// 推进 ticks 个tick，返回第一个tick的编号
+static uint32_t ticks_from(uint32_t ticks) {
+    uint32_t first = bits_button_get_tick() + 1;
+    time_simulate_ticks(ticks);
+    return first;
+}
+
+// ==================== 时间戳测试 ====================
+
+void test_event_timestamps(void) {
+    printf("\n=== 测试事件时间戳 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static uint16_t combo_keys[] = {2, 3};
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param),
+        BITS_BUTTON_INIT(3, 1, &param)
+    };
+    button_obj_combo_t combos[] = {
+        BITS_BUTTON_COMBO_INIT(100, 1, &param, combo_keys, 2, 1)
+    };
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .btns_combo = combos,
+        .btns_combo_cnt = ARRAY_SIZE(combos),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+
+    // 按下时抖动一次：抖回原电平的边沿被取消，从最后一次变化开始计时
+    mock_button_press(1);
+    time_simulate_ticks(2);
+    mock_button_release(1);
+    time_simulate_ticks(1);
+    mock_button_press(1);
+    uint32_t press_edge = ticks_from(1);
+    time_simulate_debounce_delay();
+
+    const bits_btn_result_t *pressed = find_event(1, BTN_EVENT_PRESSED);
+    TEST_ASSERT_NOT_NULL(pressed);
+    TEST_ASSERT_EQUAL_UINT32(press_edge, pressed->edge_tick);
+    TEST_ASSERT_TRUE(pressed->accept_tick > pressed->edge_tick);
+    TEST_ASSERT_EQUAL_UINT32(pressed->accept_tick, pressed->report_tick);
+
+    // 长按事件沿用按下的边沿，上报时间是长按触发的tick
+    time_simulate_long_press_threshold();
+    const bits_btn_result_t *long_press = find_event(1, BTN_EVENT_LONG_PRESS);
+    TEST_ASSERT_NOT_NULL(long_press);
+    TEST_ASSERT_EQUAL_UINT32(press_edge, long_press->edge_tick);
+    TEST_ASSERT_EQUAL_UINT32(pressed->accept_tick, long_press->accept_tick);
+    TEST_ASSERT_TRUE(long_press->report_tick > long_press->accept_tick);
+
+    // 结束事件的边沿是松开，上报在时间窗口之后
+    mock_button_release(1);
+    uint32_t release_edge = ticks_from(1);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    const bits_btn_result_t *finish = find_event(1, BTN_EVENT_FINISH);
+    TEST_ASSERT_NOT_NULL(finish);
+    TEST_ASSERT_EQUAL_UINT32(release_edge, finish->edge_tick);
+    TEST_ASSERT_TRUE(finish->report_tick - finish->accept_tick >= time_ms_to_ticks(TEST_TIME_WINDOW_MS));
+
+    // 组合键取最近一个按键的边沿
+    test_framework_clear_events();
+    mock_button_press(2);
+    time_simulate_ticks(1);
+    mock_button_press(3);
+    uint32_t combo_edge = ticks_from(1);
+    time_simulate_debounce_delay();
+    const bits_btn_result_t *combo_pressed = find_event(100, BTN_EVENT_PRESSED);
+    TEST_ASSERT_NOT_NULL(combo_pressed);
+    TEST_ASSERT_EQUAL_UINT32(combo_edge, combo_pressed->edge_tick);
+    mock_button_release(2);
+    mock_button_release(3);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+
+    printf("事件时间戳测试通过\n");
+}
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+void test_event_queue_age(void) {
+    printf("\n=== 测试缓冲区队列延迟 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param)
+    };
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+    TEST_ASSERT_EQUAL_UINT32(0, bits_button_get_queue_age());
+
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    const bits_btn_result_t *finish = find_event(1, BTN_EVENT_FINISH);
+    TEST_ASSERT_NOT_NULL(finish);
+
+    // 消费者迟到多少tick，队列延迟就是多少
+    uint32_t waited = bits_button_get_tick() - finish->report_tick;
+    time_simulate_ticks(10);
+    TEST_ASSERT_EQUAL_UINT32(waited + 10, bits_button_get_queue_age());
+
+    // 一次补上的tick同样计入队列延迟
+    bits_button_ticks_elapsed(50);
+    TEST_ASSERT_EQUAL_UINT32(waited + 60, bits_button_get_queue_age());
+
+    bits_btn_result_t result;
+    TEST_ASSERT_TRUE(bits_button_get_key_result(&result));
+    TEST_ASSERT_EQUAL_UINT32(finish->report_tick, result.report_tick);
+    TEST_ASSERT_EQUAL_UINT32(finish->edge_tick, result.edge_tick);
+    TEST_ASSERT_EQUAL_UINT32(0, bits_button_get_queue_age());
+
+    printf("缓冲区队列延迟测试通过\n");
+}
+#endif
+
+#endif
@@ -308,4 +308,69 @@ void test_callback_functions(void) {
     printf("✓ 完整回调配置正常工作\n");
     
     printf("✓ 回调函数测试通过: 所有回调组合都经过验证\n");
-}
\ No newline at end of file
+}
+// ==================== 批量读取回调测试 ====================
+
+// 批量读取回调对应的按键ID表（bit i 对应 btns[i]）
+static const uint8_t read_mask_key_ids[] = {1, 2, 3};
+
+static bits_btn_mask_t mock_read_button_mask(void) {
+    bits_btn_mask_t raw = BITS_BTN_MASK_ZERO_INIT;
+    for (size_t i = 0; i < ARRAY_SIZE(read_mask_key_ids); i++) {
+        if (mock_get_button_state(read_mask_key_ids[i])) {
+            BITS_BTN_MASK_SET_BIT(raw, i);
+        }
+    }
+    return raw;
+}
+
+void test_read_mask_callback(void) {
+    printf("\n=== 测试批量读取回调 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 0, &param),  // 低电平有效
+        BITS_BUTTON_INIT(3, 1, &param)
+    };
+
+    // 只提供批量读取回调
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = 3,
+        .read_button_level_func = NULL,
+        .read_button_mask_func = mock_read_button_mask,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .bits_btn_debug_printf = test_framework_log_printf
+    };
+
+    // 低电平有效的按键2在空闲时保持高电平
+    mock_button_press(2);
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+    bits_button_reset_states();
+
+    // 空闲期间不应产生任何事件
+    time_simulate_pass(200);
+    TEST_ASSERT_EQUAL_MESSAGE(0, test_framework_get_event_count(), "空闲时不应产生事件");
+
+    // 高电平有效按键单击
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+
+    // 低电平有效按键单击：拉低即为按下
+    mock_button_release(2);
+    time_simulate_debounce_delay();
+    time_simulate_pass(STANDARD_CLICK_TIME_MS);
+    mock_button_press(2);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(2, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+    ASSERT_EVENT_NOT_EXISTS(3, BTN_EVENT_PRESSED);
+
+    // 两个读取回调都为空时初始化失败
+    config.read_button_mask_func = NULL;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init(&config));
+
+    printf("批量读取回调测试通过\n");
+}
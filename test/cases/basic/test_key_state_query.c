@@ -0,0 +1,157 @@
+/* test_key_state_query.c - 按键状态查询接口测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+// ==================== 辅助函数 ====================
+
+static bits_btn_key_state_t state_in_callback;
+static int32_t state_in_callback_ret;
+
+// 在回调中查询状态，不应阻塞
+static void query_event_callback(struct button_obj_t *btn, bits_btn_result_t result) {
+    if (result.event == BTN_EVENT_PRESSED) {
+        state_in_callback_ret = bits_button_get_key_state(result.key_id, &state_in_callback);
+    }
+    test_framework_event_callback(btn, result);
+}
+
+// ==================== 状态查询测试 ====================
+
+void test_key_state_query(void) {
+    printf("\n=== 测试按键状态查询 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static uint16_t combo_keys[] = {2, 3};
+    button_obj_t buttons[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param),
+        BITS_BUTTON_INIT(3, 1, &param)
+    };
+    button_obj_combo_t combos[] = {
+        BITS_BUTTON_COMBO_INIT(100, 1, &param, combo_keys, 2, 1)
+    };
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .btns_combo = combos,
+        .btns_combo_cnt = ARRAY_SIZE(combos),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = query_event_callback,
+        .bits_btn_debug_printf = NULL
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+
+    bits_btn_key_state_t state;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_KEY_NOT_FOUND, bits_button_get_key_state(42, &state));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_get_key_state(1, NULL));
+    TEST_ASSERT_FALSE(bits_button_is_key_held(1));
+
+    // 按下并保持：回调中即可看到按住状态，按住时长随tick增长
+    mock_button_press(1);
+    time_simulate_debounce_delay();
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, state_in_callback_ret);
+    TEST_ASSERT_EQUAL_UINT8(1, state_in_callback.held);
+    TEST_ASSERT_EQUAL_UINT32(0, state_in_callback.held_ticks);
+    TEST_ASSERT_TRUE(bits_button_is_key_held(1));
+    uint32_t held_before = bits_button_get_key_held_ticks(1);
+    time_simulate_ticks(10);
+    TEST_ASSERT_EQUAL_UINT32(held_before + 10, bits_button_get_key_held_ticks(1));
+    TEST_ASSERT_EQUAL_UINT8(1, bits_button_get_key_click_count(1));
+    TEST_ASSERT_EQUAL_UINT32(0b1, bits_button_get_key_state_bits(1));
+
+    // 松开后第二次按下：连击计数在FINISH之前即可获得
+    mock_button_release(1);
+    time_simulate_debounce_delay();
+    TEST_ASSERT_FALSE(bits_button_is_key_held(1));
+    TEST_ASSERT_EQUAL_UINT32(0, bits_button_get_key_held_ticks(1));
+    TEST_ASSERT_EQUAL_UINT32(0b10, bits_button_get_key_state_bits(1));
+    mock_button_press(1);
+    time_simulate_debounce_delay();
+    TEST_ASSERT_EQUAL_UINT8(2, bits_button_get_key_click_count(1));
+    TEST_ASSERT_EQUAL_UINT32(0b101, bits_button_get_key_state_bits(1));
+    mock_button_release(1);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_DOUBLE_CLICK_KV);
+    TEST_ASSERT_EQUAL_UINT8(0, bits_button_get_key_click_count(1));
+
+    // 组合键也可以按 key_id 查询，被抑制的单键保持空闲
+    mock_button_press(2);
+    mock_button_press(3);
+    time_simulate_debounce_delay();
+    TEST_ASSERT_TRUE(bits_button_is_key_held(100));
+    TEST_ASSERT_FALSE(bits_button_is_key_held(2));
+    mock_button_release(2);
+    mock_button_release(3);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+
+    printf("按键状态查询测试通过\n");
+}
+
+// ==================== 哈希冲突测试 ====================
+
+static uint8_t collide_levels[8];
+
+static bits_btn_mask_t collide_read_mask(void) {
+    bits_btn_mask_t mask = BITS_BTN_MASK_ZERO_INIT;
+    for (uint16_t i = 0; i < ARRAY_SIZE(collide_levels); i++) {
+        if (collide_levels[i]) {
+            BITS_BTN_MASK_SET_BIT(mask, i);
+        }
+    }
+    return mask;
+}
+
+void test_key_index_map_collisions(void) {
+    printf("\n=== 测试按键索引映射冲突 ===\n");
+
+    // 所有 key_id 落在同一个哈希槽
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static uint16_t combo_keys[2];
+    button_obj_t buttons[ARRAY_SIZE(collide_levels)];
+    for (uint16_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+        button_obj_t btn = BITS_BUTTON_INIT(3 + i * BITS_BTN_KEY_MAP_SIZE, 1, &param);
+        buttons[i] = btn;
+        collide_levels[i] = 0;
+    }
+    combo_keys[0] = buttons[6].key_id;
+    combo_keys[1] = buttons[7].key_id;
+    button_obj_combo_t combos[] = {
+        BITS_BUTTON_COMBO_INIT(3 + 8 * BITS_BTN_KEY_MAP_SIZE, 1, &param, combo_keys, 2, 1)
+    };
+
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .btns_combo = combos,
+        .btns_combo_cnt = ARRAY_SIZE(combos),
+        .bits_btn_result_cb = test_framework_event_callback,
+        .read_button_mask_func = collide_read_mask
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+
+    collide_levels[5] = 1;
+    time_simulate_debounce_delay();
+    for (uint16_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+        TEST_ASSERT_EQUAL_UINT8(i == 5, bits_button_is_key_held(buttons[i].key_id));
+    }
+
+    collide_levels[6] = 1;
+    collide_levels[7] = 1;
+    time_simulate_debounce_delay();
+    TEST_ASSERT_TRUE(bits_button_is_key_held(combos[0].btn.key_id));
+    bits_btn_key_state_t state;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_KEY_NOT_FOUND, bits_button_get_key_state(3 + 9 * BITS_BTN_KEY_MAP_SIZE, &state));
+
+    // 组合键不能引用另一个组合键的 key_id
+    combo_keys[1] = combos[0].btn.key_id;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_COMBO_ID, bits_button_init(&config));
+
+    printf("按键索引映射冲突测试通过\n");
+}
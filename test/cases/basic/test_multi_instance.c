@@ -0,0 +1,217 @@
+/* test_multi_instance.c - 多实例上下文API测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+#include <string.h>
+
+// ==================== 辅助函数 ====================
+
+static void tick_instances(bits_button_t *a, bits_button_t *b, uint32_t ms) {
+    for (uint32_t i = 0; i < time_ms_to_ticks(ms); i++) {
+        bits_button_ticks_ctx(a);
+        bits_button_ticks_ctx(b);
+    }
+}
+
+static void click_on_instances(bits_button_t *a, bits_button_t *b, uint8_t key_id) {
+    mock_button_press(key_id);
+    tick_instances(a, b, DEBOUNCE_DELAY_MS + STANDARD_CLICK_TIME_MS);
+    mock_button_release(key_id);
+    tick_instances(a, b, DEBOUNCE_DELAY_MS);
+}
+
+// ==================== 多实例独立性测试 ====================
+
+void test_multi_instance_independence(void) {
+    printf("\n=== 测试多实例独立运行 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t panel_a_btns[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param)
+    };
+    button_obj_t panel_b_btns[] = {
+        BITS_BUTTON_INIT(3, 1, &param),
+        BITS_BUTTON_INIT(4, 1, &param)
+    };
+    static bits_button_t panel_a;
+    static bits_button_t panel_b;
+
+    bits_btn_config_t config_a = {
+        .btns = panel_a_btns,
+        .btns_cnt = ARRAY_SIZE(panel_a_btns),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .bits_btn_debug_printf = NULL
+    };
+    bits_btn_config_t config_b = config_a;
+    config_b.btns = panel_b_btns;
+    config_b.btns_cnt = ARRAY_SIZE(panel_b_btns);
+
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel_a, &config_a));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel_b, &config_b));
+
+    // 实例A单击按键1，实例B双击按键4
+    click_on_instances(&panel_a, &panel_b, 1);
+    click_on_instances(&panel_a, &panel_b, 4);
+    tick_instances(&panel_a, &panel_b, 100);
+    click_on_instances(&panel_a, &panel_b, 4);
+    tick_instances(&panel_a, &panel_b, TIME_WINDOW_DEFAULT_MS + 10);
+
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+    ASSERT_EVENT_WITH_VALUE(4, BTN_EVENT_FINISH, BITS_BTN_DOUBLE_CLICK_KV);
+
+    // 每个实例都有独立的结果缓冲区
+    bits_btn_result_t result;
+    TEST_ASSERT_EQUAL(1, get_bits_btn_buffer_used_count_ctx(&panel_a));
+    TEST_ASSERT_TRUE(bits_button_get_key_result_ctx(&panel_a, &result));
+    TEST_ASSERT_EQUAL(1, result.key_id);
+    TEST_ASSERT_TRUE(bits_btn_is_buffer_empty_ctx(&panel_a));
+
+    TEST_ASSERT_TRUE(bits_button_peek_key_result_ctx(&panel_b, &result));
+    TEST_ASSERT_EQUAL(4, result.key_id);
+    TEST_ASSERT_TRUE(bits_button_get_key_result_ctx(&panel_b, &result));
+    TEST_ASSERT_EQUAL(BITS_BTN_DOUBLE_CLICK_KV, result.key_value);
+    TEST_ASSERT_FALSE(bits_button_get_key_result_ctx(&panel_b, &result));
+
+    // 默认实例不受影响
+    TEST_ASSERT_TRUE(bits_btn_is_buffer_empty());
+
+    printf("多实例独立运行测试通过\n");
+}
+
+// 每个实例的过滤回调互不影响
+static uint8_t accept_all_filter(bits_btn_result_t result) {
+    (void)result;
+    return 1;
+}
+
+void test_multi_instance_filter(void) {
+    printf("\n=== 测试多实例过滤回调 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t panel_a_btns[] = { BITS_BUTTON_INIT(1, 1, &param) };
+    button_obj_t panel_b_btns[] = { BITS_BUTTON_INIT(1, 1, &param) };
+    static bits_button_t panel_a;
+    static bits_button_t panel_b;
+
+    bits_btn_config_t config_a = {
+        .btns = panel_a_btns,
+        .btns_cnt = 1,
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = NULL,
+        .bits_btn_debug_printf = NULL
+    };
+    bits_btn_config_t config_b = config_a;
+    config_b.btns = panel_b_btns;
+
+    // 过滤回调可以在初始化之前注册
+    bits_btn_register_result_filter_callback_ctx(&panel_a, accept_all_filter);
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel_a, &config_a));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel_b, &config_b));
+
+    click_on_instances(&panel_a, &panel_b, 1);
+    tick_instances(&panel_a, &panel_b, TIME_WINDOW_DEFAULT_MS + 10);
+
+    // A: PRESSED + RELEASE + FINISH，B: 仅默认过滤的FINISH
+    TEST_ASSERT_EQUAL(3, get_bits_btn_buffer_used_count_ctx(&panel_a));
+    TEST_ASSERT_EQUAL(1, get_bits_btn_buffer_used_count_ctx(&panel_b));
+
+    // 重新初始化保留过滤回调，deinit清零实例后过滤回调一并清除
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel_a, &config_a));
+    click_on_instances(&panel_a, &panel_b, 1);
+    tick_instances(&panel_a, &panel_b, TIME_WINDOW_DEFAULT_MS + 10);
+    TEST_ASSERT_EQUAL(3, get_bits_btn_buffer_used_count_ctx(&panel_a));
+    bits_button_deinit_ctx(&panel_a);
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel_a, &config_a));
+    click_on_instances(&panel_a, &panel_b, 1);
+    tick_instances(&panel_a, &panel_b, TIME_WINDOW_DEFAULT_MS + 10);
+    TEST_ASSERT_EQUAL(1, get_bits_btn_buffer_used_count_ctx(&panel_a));
+
+    // 首次初始化前未清零的实例存储被拒绝
+    static bits_button_t dirty;
+    memset(&dirty, 0xA5, sizeof(dirty));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init_ctx(&dirty, &config_a));
+    memset(&dirty, 0, sizeof(dirty));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&dirty, &config_a));
+
+    printf("多实例过滤回调测试通过\n");
+}
+
+// ==================== 调用方提供的缓冲区测试 ====================
+
+void test_multi_instance_buffer_storage(void) {
+    printf("\n=== 测试实例使用调用方提供的缓冲区 ===\n");
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    button_obj_t panel_btns[] = {
+        BITS_BUTTON_INIT(1, 1, &param),
+        BITS_BUTTON_INIT(2, 1, &param)
+    };
+    button_obj_t remote_btns[] = {
+        BITS_BUTTON_INIT(3, 1, &param)
+    };
+    static bits_button_t panel;
+    static bits_button_t remote;
+    static bits_btn_result_t panel_storage[64];
+    static bits_btn_result_t remote_storage[4];
+
+    // 按键多的面板用深队列，遥控器用浅队列
+    bits_btn_config_t panel_config = {
+        .btns = panel_btns,
+        .btns_cnt = ARRAY_SIZE(panel_btns),
+        .read_button_level_func = test_framework_mock_read_button,
+        .buffer_storage = panel_storage,
+        .buffer_storage_size = ARRAY_SIZE(panel_storage)
+    };
+    bits_btn_config_t remote_config = panel_config;
+    remote_config.btns = remote_btns;
+    remote_config.btns_cnt = ARRAY_SIZE(remote_btns);
+    remote_config.buffer_storage = remote_storage;
+    remote_config.buffer_storage_size = ARRAY_SIZE(remote_storage);
+
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&panel, &panel_config));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&remote, &remote_config));
+
+    size_t panel_capacity = get_bits_btn_buffer_capacity_ctx(&panel);
+    size_t remote_capacity = get_bits_btn_buffer_capacity_ctx(&remote);
+    TEST_ASSERT_TRUE(panel_capacity >= ARRAY_SIZE(panel_storage) - 1);
+    TEST_ASSERT_TRUE(remote_capacity >= ARRAY_SIZE(remote_storage) - 1 && remote_capacity <= ARRAY_SIZE(remote_storage));
+
+    const size_t clicks = 20;
+    for (size_t i = 0; i < clicks; i++) {
+        click_on_instances(&panel, &remote, 1);
+        click_on_instances(&panel, &remote, 3);
+        tick_instances(&panel, &remote, TIME_WINDOW_DEFAULT_MS + 10);
+    }
+
+    // 面板的事件全部保留，遥控器只保留最新的几个
+    TEST_ASSERT_EQUAL(clicks, get_bits_btn_buffer_used_count_ctx(&panel));
+    TEST_ASSERT_EQUAL(0, get_bits_btn_buffer_overwrite_count_ctx(&panel));
+    TEST_ASSERT_EQUAL(remote_capacity, get_bits_btn_buffer_used_count_ctx(&remote));
+    TEST_ASSERT_EQUAL(clicks - remote_capacity, get_bits_btn_buffer_overwrite_count_ctx(&remote));
+
+    bits_btn_result_t results[64];
+    TEST_ASSERT_EQUAL(remote_capacity, bits_button_get_key_results_ctx(&remote, results, ARRAY_SIZE(results)));
+    for (size_t i = 0; i < remote_capacity; i++) {
+        TEST_ASSERT_EQUAL(3, results[i].key_id);
+        TEST_ASSERT_EQUAL(BITS_BTN_SINGLE_CLICK_KV, results[i].key_value);
+    }
+
+    // 存储与容量必须成对给出
+    remote_config.buffer_storage = NULL;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init_ctx(&remote, &remote_config));
+    remote_config.buffer_storage = remote_storage;
+    remote_config.buffer_storage_size = 1;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init_ctx(&remote, &remote_config));
+#ifdef BITS_BTN_USE_POW2_BUFFER
+    remote_config.buffer_storage_size = 3;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init_ctx(&remote, &remote_config));
+#endif
+
+    printf("调用方提供的缓冲区测试通过: 面板容量 %zu, 遥控器容量 %zu\n", panel_capacity, remote_capacity);
+}
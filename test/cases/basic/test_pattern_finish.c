@@ -0,0 +1,195 @@
+/* test_pattern_finish.c - 注册键值模式提前结束测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+// ==================== 辅助函数 ====================
+
+static const bits_btn_obj_param_t pattern_param = TEST_DEFAULT_PARAM();
+static button_obj_t pattern_btns[3];
+
+static int32_t pattern_init_engine(const bits_btn_pattern_set_t *sets, uint16_t sets_cnt,
+                                   bits_btn_engine_t engine, bits_btn_result_callback cb) {
+    for (uint16_t i = 0; i < ARRAY_SIZE(pattern_btns); i++) {
+        pattern_btns[i] = (button_obj_t)BITS_BUTTON_INIT(i + 1, 1, &pattern_param);
+    }
+
+    bits_btn_config_t config = {
+        .btns = pattern_btns,
+        .btns_cnt = ARRAY_SIZE(pattern_btns),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = cb,
+        .pattern_sets = sets,
+        .pattern_sets_cnt = sets_cnt,
+        .engine = engine
+    };
+    return bits_button_init(&config);
+}
+
+static int32_t pattern_init(const bits_btn_pattern_set_t *sets, uint16_t sets_cnt) {
+    return pattern_init_engine(sets, sets_cnt, BITS_BTN_ENGINE_SWITCH, test_framework_event_callback);
+}
+
+#ifdef BITS_BTN_ENABLE_PATTERNS
+// 单击后松开并等待消抖，再走两个tick：松开事件一个tick，FINISH一个tick
+static void pattern_click(uint8_t button_id) {
+    mock_button_click(button_id, STANDARD_CLICK_TIME_MS);
+    time_simulate_ticks(2);
+}
+
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+// RELEASE回调中看到的按键状态，按按键ID记录
+static uint8_t release_states[ARRAY_SIZE(pattern_btns) + 1];
+static bits_btn_key_state_t release_key_states[ARRAY_SIZE(pattern_btns) + 1];
+
+static void pattern_release_callback(struct button_obj_t *btn, bits_btn_result_t result) {
+    if (result.event == BTN_EVENT_RELEASE) {
+        release_states[result.key_id] = btn->current_state;
+        TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_get_key_state(result.key_id, &release_key_states[result.key_id]));
+    }
+    test_framework_event_callback(btn, result);
+}
+#endif
+#endif
+
+// ==================== 提前结束测试 ====================
+
+void test_pattern_early_finish(void) {
+    printf("\n=== 测试注册键值模式提前结束 ===\n");
+
+#ifdef BITS_BTN_ENABLE_PATTERNS
+    static const state_bits_type_t single_only[] = {BITS_BTN_SINGLE_CLICK_KV};
+    static const state_bits_type_t single_double[] = {BITS_BTN_SINGLE_CLICK_KV, BITS_BTN_DOUBLE_CLICK_KV};
+    const bits_btn_pattern_set_t sets[] = {
+        {.key_id = 1, .pattern_cnt = ARRAY_SIZE(single_only), .patterns = single_only},
+        {.key_id = 2, .pattern_cnt = ARRAY_SIZE(single_double), .patterns = single_double},
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, pattern_init(sets, ARRAY_SIZE(sets)));
+
+    // 只关心单击：松开后立即结束，不等时间窗口
+    pattern_click(1);
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+
+    // 还可能双击：单击后照常等待时间窗口
+    pattern_click(2);
+    ASSERT_EVENT_NOT_EXISTS(2, BTN_EVENT_FINISH);
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(2, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+
+    // 双击之后不会再有更长的模式，第二次松开即结束
+    test_framework_reset();
+    mock_button_click(2, STANDARD_CLICK_TIME_MS);
+    time_simulate_pass(STANDARD_CLICK_TIME_MS);
+    pattern_click(2);
+    ASSERT_EVENT_WITH_VALUE(2, BTN_EVENT_FINISH, BITS_BTN_DOUBLE_CLICK_KV);
+
+    // 未注册模式的按键行为不变
+    pattern_click(3);
+    ASSERT_EVENT_NOT_EXISTS(3, BTN_EVENT_FINISH);
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(3, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+
+    // 长按松开后已偏离所有注册模式，同样立即结束
+    test_framework_reset();
+    mock_button_press(1);
+    time_simulate_debounce_delay();
+    time_simulate_long_press_threshold();
+    mock_button_release(1);
+    time_simulate_debounce_delay();
+    time_simulate_ticks(2);
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, 0b110);
+
+    printf("注册键值模式提前结束测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_PATTERNS\n");
+#endif
+}
+
+void test_pattern_finish_engines_agree(void) {
+    printf("\n=== 测试各引擎提前结束的顺序一致 ===\n");
+
+#if defined(BITS_BTN_ENABLE_PATTERNS) && defined(BITS_BTN_ENABLE_TABLE_ENGINE)
+    static const state_bits_type_t single_only[] = {BITS_BTN_SINGLE_CLICK_KV};
+    const bits_btn_pattern_set_t sets[] = {
+        {.key_id = 1, .pattern_cnt = ARRAY_SIZE(single_only), .patterns = single_only},
+    };
+    const bits_btn_engine_t engines[] = {BITS_BTN_ENGINE_SWITCH, BITS_BTN_ENGINE_TABLE};
+    uint8_t seen[ARRAY_SIZE(engines)];
+
+    for (size_t e = 0; e < ARRAY_SIZE(engines); e++) {
+        test_framework_reset();
+        TEST_ASSERT_EQUAL(BITS_BTN_OK, pattern_init_engine(sets, ARRAY_SIZE(sets), engines[e], pattern_release_callback));
+
+        // 按键3没有注册模式，RELEASE回调时处于等待时间窗口的状态
+        pattern_click(3);
+        pattern_click(1);
+        ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+        ASSERT_EVENT_NOT_EXISTS(3, BTN_EVENT_FINISH);
+
+        // 提前结束发生在RELEASE回调之后，回调看到的状态与未注册模式的按键相同
+        TEST_ASSERT_EQUAL_UINT8(release_states[3], release_states[1]);
+        TEST_ASSERT_FALSE(release_key_states[1].held);
+        TEST_ASSERT_EQUAL_UINT8(1, release_key_states[1].click_count);
+        seen[e] = release_states[1];
+    }
+    TEST_ASSERT_EQUAL_UINT8(seen[0], seen[1]);
+
+    printf("各引擎提前结束顺序一致测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_PATTERNS或BITS_BTN_ENABLE_TABLE_ENGINE\n");
+#endif
+}
+
+void test_pattern_sets_invalid(void) {
+    printf("\n=== 测试非法的键值模式配置 ===\n");
+
+    static const state_bits_type_t zero_pattern[] = {BITS_BTN_SINGLE_CLICK_KV, 0};
+    static const state_bits_type_t long_a[] = {0xAAAAU};
+    static const state_bits_type_t long_b[] = {0xAAAAU};
+    const bits_btn_pattern_set_t unknown_key[] = {
+        {.key_id = 42, .pattern_cnt = 1, .patterns = long_a},
+    };
+    const bits_btn_pattern_set_t bad_patterns[] = {
+        {.key_id = 1, .pattern_cnt = ARRAY_SIZE(zero_pattern), .patterns = zero_pattern},
+    };
+    const bits_btn_pattern_set_t empty_set[] = {
+        {.key_id = 1, .pattern_cnt = 0, .patterns = long_a},
+    };
+    // 同一个数组共用一棵树，不同数组各自占用节点
+    const bits_btn_pattern_set_t shared[] = {
+        {.key_id = 1, .pattern_cnt = 1, .patterns = long_a},
+        {.key_id = 2, .pattern_cnt = 1, .patterns = long_a},
+    };
+    const bits_btn_pattern_set_t separate[] = {
+        {.key_id = 1, .pattern_cnt = 1, .patterns = long_a},
+        {.key_id = 2, .pattern_cnt = 1, .patterns = long_b},
+    };
+
+#ifdef BITS_BTN_ENABLE_PATTERNS
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_KEY_NOT_FOUND, pattern_init(unknown_key, ARRAY_SIZE(unknown_key)));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, pattern_init(bad_patterns, ARRAY_SIZE(bad_patterns)));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, pattern_init(empty_set, ARRAY_SIZE(empty_set)));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, pattern_init(NULL, 1));
+#if BITS_BTN_MAX_PATTERN_NODES >= 17 && BITS_BTN_MAX_PATTERN_NODES < 34
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, pattern_init(shared, ARRAY_SIZE(shared)));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_TOO_MANY_PATTERNS, pattern_init(separate, ARRAY_SIZE(separate)));
+#else
+    (void)shared;
+    (void)separate;
+#endif
+#else
+    // 未编译键值模式时注册任何模式都被拒绝
+    (void)unknown_key;
+    (void)bad_patterns;
+    (void)empty_set;
+    (void)separate;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, pattern_init(shared, ARRAY_SIZE(shared)));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, pattern_init(NULL, 0));
+#endif
+
+    printf("非法键值模式配置测试通过\n");
+}
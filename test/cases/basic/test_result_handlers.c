@@ -0,0 +1,187 @@
+/* test_result_handlers.c - 事件处理函数表测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#ifdef BITS_BTN_ENABLE_HANDLERS
+
+// ==================== 辅助函数 ====================
+
+static const bits_btn_obj_param_t handler_param = TEST_DEFAULT_PARAM();
+static button_obj_t handler_btns[3];
+static uint16_t handler_combo_keys[] = {2, 3};
+static button_obj_combo_t handler_combos[1];
+static bits_btn_result_t handler_last_result;
+
+// user_data 指向各自的计数器
+static void count_handler(bits_btn_result_t result, void *user_data) {
+    (*(uint32_t *)user_data)++;
+    handler_last_result = result;
+}
+
+static int32_t handler_init(const bits_btn_handler_t *handlers, uint16_t handlers_cnt, uint8_t on_drain) {
+    for (uint16_t i = 0; i < ARRAY_SIZE(handler_btns); i++) {
+        handler_btns[i] = (button_obj_t)BITS_BUTTON_INIT(i + 1, 1, &handler_param);
+    }
+    handler_combos[0] = (button_obj_combo_t)BITS_BUTTON_COMBO_INIT(100, 1, &handler_param, handler_combo_keys, 2, 1);
+
+    bits_btn_config_t config = {
+        .btns = handler_btns,
+        .btns_cnt = ARRAY_SIZE(handler_btns),
+        .btns_combo = handler_combos,
+        .btns_combo_cnt = ARRAY_SIZE(handler_combos),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .handlers = handlers,
+        .handlers_cnt = handlers_cnt,
+        .handlers_on_drain = on_drain
+    };
+    return bits_button_init(&config);
+}
+
+// ==================== 处理函数分发测试 ====================
+
+void test_result_handlers_dispatch(void) {
+    printf("\n=== 测试事件处理函数表分发 ===\n");
+
+    static uint32_t pressed_cnt, single_cnt, double_cnt, combo_cnt;
+    pressed_cnt = single_cnt = double_cnt = combo_cnt = 0;
+    const bits_btn_handler_t handlers[] = {
+        {.key_id = 1, .event = BTN_EVENT_PRESSED, .key_value = BITS_BTN_ANY_KEY_VALUE, .handler = count_handler, .user_data = &pressed_cnt},
+        {.key_id = 1, .event = BTN_EVENT_FINISH, .key_value = BITS_BTN_SINGLE_CLICK_KV, .handler = count_handler, .user_data = &single_cnt},
+        {.key_id = 1, .event = BTN_EVENT_FINISH, .key_value = BITS_BTN_DOUBLE_CLICK_KV, .handler = count_handler, .user_data = &double_cnt},
+        {.key_id = 100, .event = BTN_EVENT_FINISH, .key_value = BITS_BTN_ANY_KEY_VALUE, .handler = count_handler, .user_data = &combo_cnt},
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, handler_init(handlers, ARRAY_SIZE(handlers), 0));
+
+    // 单击：按下处理函数与单击处理函数各执行一次，回调照常收到事件
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+    TEST_ASSERT_EQUAL_UINT32(1, pressed_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, single_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, double_cnt);
+    TEST_ASSERT_EQUAL_UINT16(1, handler_last_result.key_id);
+
+    // 双击：精确匹配的键值只命中双击处理函数
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_pass(STANDARD_CLICK_TIME_MS);
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL_UINT32(3, pressed_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, single_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, double_cnt);
+
+    // 组合键用任意键值处理函数兜底
+    mock_button_press(2);
+    mock_button_press(3);
+    time_simulate_debounce_delay();
+    mock_button_release(2);
+    mock_button_release(3);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL_UINT32(1, combo_cnt);
+    TEST_ASSERT_EQUAL_UINT16(100, handler_last_result.key_id);
+
+    // 没有处理函数的事件返回0
+    bits_btn_result_t result = {.event = BTN_EVENT_FINISH, .key_id = 2, .key_value = BITS_BTN_SINGLE_CLICK_KV};
+    TEST_ASSERT_EQUAL_UINT8(0, bits_button_dispatch_result(&result));
+    TEST_ASSERT_EQUAL_UINT8(0, bits_button_dispatch_result(NULL));
+
+    printf("事件处理函数表分发测试通过\n");
+}
+
+void test_result_handlers_full_table(void) {
+    printf("\n=== 测试事件处理函数表装满 ===\n");
+
+    // 处理函数数量等于表长，探测链覆盖整张表
+    static bits_btn_handler_t handlers[BITS_BTN_HANDLER_MAP_SIZE];
+    static uint32_t counts[BITS_BTN_HANDLER_MAP_SIZE];
+    for (uint16_t i = 0; i < ARRAY_SIZE(handlers); i++) {
+        handlers[i] = (bits_btn_handler_t){
+            .key_id = (uint16_t)(1 + i % 3), .event = BTN_EVENT_FINISH,
+            .key_value = (state_bits_type_t)(i + 1), .handler = count_handler, .user_data = &counts[i]
+        };
+        counts[i] = 0;
+    }
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, handler_init(handlers, ARRAY_SIZE(handlers), 0));
+
+    for (uint16_t i = 0; i < ARRAY_SIZE(handlers); i++) {
+        bits_btn_result_t result = {.event = BTN_EVENT_FINISH, .key_id = handlers[i].key_id, .key_value = handlers[i].key_value};
+        TEST_ASSERT_EQUAL_UINT8(1, bits_button_dispatch_result(&result));
+        TEST_ASSERT_EQUAL_UINT32(1, counts[i]);
+    }
+
+    // 表满时查找未命中也能结束
+    bits_btn_result_t miss = {.event = BTN_EVENT_FINISH, .key_id = 1, .key_value = (state_bits_type_t)(BITS_BTN_HANDLER_MAP_SIZE + 1)};
+    TEST_ASSERT_EQUAL_UINT8(0, bits_button_dispatch_result(&miss));
+
+    printf("事件处理函数表装满测试通过\n");
+}
+
+#ifndef BITS_BTN_DISABLE_BUFFER
+void test_result_handlers_on_drain(void) {
+    printf("\n=== 测试读取缓冲区时分发 ===\n");
+
+    static uint32_t single_cnt;
+    single_cnt = 0;
+    const bits_btn_handler_t handlers[] = {
+        {.key_id = 1, .event = BTN_EVENT_FINISH, .key_value = BITS_BTN_SINGLE_CLICK_KV, .handler = count_handler, .user_data = &single_cnt},
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, handler_init(handlers, ARRAY_SIZE(handlers), 1));
+
+    // tick中不执行处理函数，留给主循环读取缓冲区时分发
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL_UINT32(0, single_cnt);
+
+    bits_btn_result_t result;
+    while (bits_button_get_key_result(&result)) {
+        bits_button_dispatch_result(&result);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, single_cnt);
+
+    printf("读取缓冲区时分发测试通过\n");
+}
+#endif
+
+void test_result_handlers_invalid(void) {
+    printf("\n=== 测试无效的事件处理函数表 ===\n");
+
+    static uint32_t cnt;
+    bits_btn_handler_t handler = {.key_id = 1, .event = BTN_EVENT_FINISH, .key_value = BITS_BTN_SINGLE_CLICK_KV,
+                                  .handler = count_handler, .user_data = &cnt};
+
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, handler_init(NULL, 1, 0));
+
+    bits_btn_handler_t bad = handler;
+    bad.handler = NULL;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, handler_init(&bad, 1, 0));
+
+    bad = handler;
+    bad.event = 4;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, handler_init(&bad, 1, 0));
+
+    bad = handler;
+    bad.key_id = 42;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_KEY_NOT_FOUND, handler_init(&bad, 1, 0));
+
+    // 同一组 (key_id, event, key_value) 只能注册一次
+    const bits_btn_handler_t dup[] = {handler, handler};
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, handler_init(dup, ARRAY_SIZE(dup), 0));
+
+    static bits_btn_handler_t many[BITS_BTN_HANDLER_MAP_SIZE + 1];
+    for (uint16_t i = 0; i < ARRAY_SIZE(many); i++) {
+        many[i] = handler;
+        many[i].key_value = (state_bits_type_t)(i + 1);
+    }
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_TOO_MANY_HANDLERS, handler_init(many, ARRAY_SIZE(many), 0));
+
+    printf("无效的事件处理函数表测试通过\n");
+}
+
+#endif
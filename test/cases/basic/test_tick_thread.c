@@ -0,0 +1,170 @@
+/* test_tick_thread.c - timerfd驱动的ticks线程测试 */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/time_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+#include <errno.h>
+#include <time.h>
+
+// ==================== 辅助函数 ====================
+
+static bits_button_t tick_thread_instance;
+static atomic_int tick_thread_pressed;
+static atomic_int tick_thread_stall_ms;
+
+// 在ticks线程中调用；stall_ms 非零时阻塞一次，模拟调度延迟
+static uint8_t tick_thread_read_level(struct button_obj_t *btn) {
+    (void)btn;
+    int stall_ms = atomic_exchange(&tick_thread_stall_ms, 0);
+    if (stall_ms) {
+        struct timespec delay = {0, stall_ms * 1000000L};
+        nanosleep(&delay, NULL);
+    }
+    return (uint8_t)atomic_load(&tick_thread_pressed);
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+static bits_btn_config_t tick_thread_config;
+
+static void tick_thread_init(void) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t buttons[1];
+    buttons[0] = (button_obj_t)BITS_BUTTON_INIT(1, 1, &param);
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .read_button_level_func = tick_thread_read_level
+    };
+    tick_thread_config = config;
+    atomic_store(&tick_thread_pressed, 0);
+    atomic_store(&tick_thread_stall_ms, 0);
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&tick_thread_instance, &config));
+}
+
+// ==================== ticks线程测试 ====================
+
+void test_tick_thread_runs_and_catches_up(void) {
+    printf("\n=== 测试ticks线程运行与补偿 ===\n");
+
+    tick_thread_init();
+    bits_btn_tick_thread_config_t config = BITS_BTN_TICK_THREAD_CONFIG_INIT;
+
+    // 启动前还没有唤醒，抖动最小值为0
+    bits_btn_tick_thread_stats_t stats;
+    bits_button_get_tick_thread_stats_ctx(&tick_thread_instance, &stats, 0);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.wakeups);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.jitter_min_ns);
+
+    config.period_us = BITS_BTN_TICKS_INTERVAL * 1000U;
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_start_tick_thread_ctx(&tick_thread_instance, &config));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_start_tick_thread_ctx(&tick_thread_instance, &config));
+
+    // 线程阻塞8个周期后，下一次唤醒一次性补上错过的tick
+    sleep_ms(BITS_BTN_TICKS_INTERVAL * 4);
+    atomic_store(&tick_thread_stall_ms, BITS_BTN_TICKS_INTERVAL * 8);
+
+    // 由线程驱动的ticks完成一次单击
+    atomic_store(&tick_thread_pressed, 1);
+    sleep_ms(BITS_BTN_TICKS_INTERVAL * 8 + STANDARD_CLICK_TIME_MS);
+    atomic_store(&tick_thread_pressed, 0);
+    bits_btn_result_t result = {0};
+    for (int i = 0; i < 200 && !bits_button_get_key_result_ctx(&tick_thread_instance, &result); i++) {
+        sleep_ms(5);
+    }
+
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_stop_tick_thread_ctx(&tick_thread_instance));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_stop_tick_thread_ctx(&tick_thread_instance));
+
+    TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+    TEST_ASSERT_EQUAL(BTN_EVENT_FINISH, result.event);
+    TEST_ASSERT_EQUAL_UINT32(BITS_BTN_SINGLE_CLICK_KV, result.key_value);
+
+    bits_button_get_tick_thread_stats_ctx(&tick_thread_instance, &stats, 0);
+    printf("唤醒 %llu 次, 运行 %llu 个tick, 补偿 %llu 个, 单次最多 %u 个, 抖动 %u..%u ns, 平均 %llu ns\n",
+           (unsigned long long)stats.wakeups, (unsigned long long)stats.ticks, (unsigned long long)stats.overruns,
+           stats.max_catch_up, stats.jitter_min_ns, stats.jitter_max_ns,
+           (unsigned long long)(stats.wakeups ? stats.jitter_sum_ns / stats.wakeups : 0));
+
+    // 逻辑tick与运行的tick数一致，补偿的tick都计入了超时
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)stats.ticks, bits_button_get_tick_ctx(&tick_thread_instance));
+    TEST_ASSERT_EQUAL_UINT64(stats.ticks - stats.wakeups, stats.overruns);
+    TEST_ASSERT_TRUE(stats.max_catch_up >= 5);
+    TEST_ASSERT_TRUE(stats.jitter_min_ns <= stats.jitter_max_ns);
+    uint64_t hist_total = 0;
+    for (int b = 0; b < BITS_BTN_TICK_JITTER_BUCKETS; b++) {
+        hist_total += stats.jitter_hist[b];
+    }
+    TEST_ASSERT_EQUAL_UINT64(stats.wakeups, hist_total);
+
+    // 统计在线程停止后保留，带重置的快照清零
+    bits_button_get_tick_thread_stats_ctx(&tick_thread_instance, NULL, 1);
+    bits_button_get_tick_thread_stats_ctx(&tick_thread_instance, &stats, 0);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.wakeups);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.jitter_min_ns);
+
+    printf("ticks线程运行与补偿测试通过\n");
+}
+
+void test_tick_thread_options(void) {
+    printf("\n=== 测试ticks线程选项 ===\n");
+
+    tick_thread_init();
+    bits_btn_tick_thread_config_t config = BITS_BTN_TICK_THREAD_CONFIG_INIT;
+    config.fifo_priority = 100;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_start_tick_thread_ctx(&tick_thread_instance, &config));
+
+    // 周期与BITS_BTN_TICKS_INTERVAL不一致会缩放所有时间参数，被拒绝
+    config = (bits_btn_tick_thread_config_t)BITS_BTN_TICK_THREAD_CONFIG_INIT;
+    config.period_us = BITS_BTN_TICKS_INTERVAL * 1000U + 1;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_start_tick_thread_ctx(&tick_thread_instance, &config));
+
+    // -1表示不绑定，更小的值被拒绝
+    config = (bits_btn_tick_thread_config_t)BITS_BTN_TICK_THREAD_CONFIG_INIT;
+    config.cpu = -2;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_start_tick_thread_ctx(&tick_thread_instance, &config));
+
+    // 绑定到CPU 0总是可行
+    config = (bits_btn_tick_thread_config_t)BITS_BTN_TICK_THREAD_CONFIG_INIT;
+    config.cpu = 0;
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_start_tick_thread_ctx(&tick_thread_instance, &config));
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_stop_tick_thread_ctx(&tick_thread_instance));
+
+    // 没有实时调度权限时报告系统错误
+    config.fifo_priority = 10;
+    int32_t ret = bits_button_start_tick_thread_ctx(&tick_thread_instance, &config);
+    if (ret == BITS_BTN_OK) {
+        printf("已使用SCHED_FIFO优先级10运行\n");
+        TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_stop_tick_thread_ctx(&tick_thread_instance));
+    } else {
+        TEST_ASSERT_EQUAL(BITS_BTN_ERR_SYSTEM, ret);
+        TEST_ASSERT_EQUAL_INT(EPERM, errno);
+        printf("没有SCHED_FIFO权限，返回BITS_BTN_ERR_SYSTEM\n");
+    }
+
+    // 默认选项以BITS_BTN_TICKS_INTERVAL为周期
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_start_tick_thread_ctx(&tick_thread_instance, NULL));
+    sleep_ms(BITS_BTN_TICKS_INTERVAL * 10);
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_stop_tick_thread_ctx(&tick_thread_instance));
+    TEST_ASSERT_TRUE(bits_button_get_tick_ctx(&tick_thread_instance) > 0);
+
+    // 线程运行时不能重新初始化，deinit停止线程并清零实例
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_start_tick_thread_ctx(&tick_thread_instance, NULL));
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init_ctx(&tick_thread_instance, &tick_thread_config));
+    bits_button_deinit_ctx(&tick_thread_instance);
+    TEST_ASSERT_EQUAL_UINT32(0, bits_button_get_tick_ctx(&tick_thread_instance));
+    tick_thread_init();
+
+    printf("ticks线程选项测试通过\n");
+}
+
+#endif
@@ -0,0 +1,213 @@
+/* test_tickless.c - 无节拍模式（下一截止时间 + 批量推进）测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+#include <string.h>
+
+// ==================== 辅助函数 ====================
+
+static const bits_btn_obj_param_t tickless_param = TEST_DEFAULT_PARAM();
+static uint16_t tickless_combo_keys[] = {1, 2};
+static button_obj_t tickless_btns[2];
+static button_obj_combo_t tickless_combos[1];
+
+static void tickless_init(void) {
+    button_obj_t btn1 = BITS_BUTTON_INIT(1, 1, &tickless_param);
+    button_obj_t btn2 = BITS_BUTTON_INIT(2, 1, &tickless_param);
+    button_obj_combo_t combo = BITS_BUTTON_COMBO_INIT(100, 1, &tickless_param, tickless_combo_keys, 2, 1);
+
+    tickless_btns[0] = btn1;
+    tickless_btns[1] = btn2;
+    tickless_combos[0] = combo;
+
+    bits_btn_config_t config = {
+        .btns = tickless_btns,
+        .btns_cnt = ARRAY_SIZE(tickless_btns),
+        .btns_combo = tickless_combos,
+        .btns_combo_cnt = ARRAY_SIZE(tickless_combos),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .bits_btn_debug_printf = NULL
+    };
+
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+// 模拟睡眠的主机：只在截止时间或输入变化时被唤醒
+static void tickless_run(uint32_t ticks) {
+    // 输入变化（边沿中断）立即唤醒一次
+    if (ticks > 0) {
+        bits_button_ticks_elapsed(1);
+        ticks--;
+    }
+
+    while (ticks > 0) {
+        uint32_t wait = bits_button_get_next_deadline();
+        if (wait > ticks) {
+            wait = ticks;
+        }
+        bits_button_ticks_elapsed(wait);
+        ticks -= wait;
+    }
+}
+
+typedef struct {
+    uint8_t key1;
+    uint8_t key2;
+    uint32_t ms;
+} tickless_step_t;
+
+// 单击、长按保持、组合键单击、双击
+static const tickless_step_t tickless_script[] = {
+    {1, 0, 100}, {0, 0, 600},
+    {1, 0, 3200}, {0, 0, 600},
+    {1, 1, 150}, {0, 0, 600},
+    {0, 1, 80}, {0, 0, 120}, {0, 1, 80}, {0, 0, 700},
+};
+
+static int tickless_play(bits_btn_result_t *events, uint8_t use_deadline) {
+    test_framework_reset();
+    tickless_init();
+
+    for (size_t i = 0; i < ARRAY_SIZE(tickless_script); i++) {
+        mock_set_button_state(1, tickless_script[i].key1);
+        mock_set_button_state(2, tickless_script[i].key2);
+        if (use_deadline) {
+            tickless_run(time_ms_to_ticks(tickless_script[i].ms));
+        } else {
+            time_simulate_ticks(time_ms_to_ticks(tickless_script[i].ms));
+        }
+    }
+
+    int count = test_framework_get_event_count();
+    memcpy(events, test_framework_get_events(), sizeof(bits_btn_result_t) * count);
+    return count;
+}
+
+// ==================== 截止时间测试 ====================
+
+void test_next_deadline(void) {
+    printf("\n=== 测试下一截止时间 ===\n");
+
+    tickless_init();
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(BITS_BTN_TICKS_INFINITE, bits_button_get_next_deadline(),
+                                     "全部空闲时应无截止时间");
+
+    // 按下后先等待消抖，截止时间之前的tick不会产生事件
+    mock_button_press(1);
+    bits_button_ticks();
+    uint32_t debounce_ticks = (BITS_BTN_DEBOUNCE_TIME_MS + BITS_BTN_TICKS_INTERVAL - 1) / BITS_BTN_TICKS_INTERVAL;
+    uint32_t wait = bits_button_get_next_deadline();
+    TEST_ASSERT_EQUAL_UINT32(debounce_ticks, wait);
+    time_simulate_ticks(wait - 1);
+    TEST_ASSERT_EQUAL(0, test_framework_get_event_count());
+    bits_button_ticks();
+    ASSERT_EVENT_EXISTS(1, BTN_EVENT_PRESSED);
+
+    // 按住期间截止时间指向长按阈值
+    wait = bits_button_get_next_deadline();
+    TEST_ASSERT_EQUAL_UINT32(BITS_BTN_LONG_PRESS_START_TIME_MS / BITS_BTN_TICKS_INTERVAL + 1, wait);
+
+    // 释放被采样后重新等待消抖，时间窗口结束并上报FINISH后恢复无限
+    mock_button_release(1);
+    bits_button_ticks();
+    TEST_ASSERT_EQUAL_UINT32(debounce_ticks, bits_button_get_next_deadline());
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+    TEST_ASSERT_EQUAL_UINT32(BITS_BTN_TICKS_INFINITE, bits_button_get_next_deadline());
+
+    printf("下一截止时间测试通过\n");
+}
+
+// ==================== 批量推进等价性测试 ====================
+
+void test_ticks_elapsed_matches_polling(void) {
+    printf("\n=== 测试批量推进与逐tick轮询等价 ===\n");
+
+    static bits_btn_result_t polled[MAX_TEST_EVENTS];
+    static bits_btn_result_t tickless[MAX_TEST_EVENTS];
+
+    int polled_count = tickless_play(polled, 0);
+    int tickless_count = tickless_play(tickless, 1);
+
+    TEST_ASSERT_TRUE(polled_count > 0);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(polled_count, tickless_count, "事件数量应一致");
+    for (int i = 0; i < polled_count; i++) {
+        TEST_ASSERT_EQUAL_UINT16(polled[i].key_id, tickless[i].key_id);
+        TEST_ASSERT_EQUAL_UINT8(polled[i].event, tickless[i].event);
+        TEST_ASSERT_EQUAL_UINT32(polled[i].key_value, tickless[i].key_value);
+        TEST_ASSERT_EQUAL_UINT16(polled[i].long_press_period_trigger_cnt, tickless[i].long_press_period_trigger_cnt);
+    }
+
+    printf("批量推进等价性测试通过 (%d 个事件)\n", polled_count);
+}
+
+// ==================== 批量追赶测试 ====================
+
+static uint32_t catch_up_read_count;
+static uint32_t catch_up_event_ticks[MAX_TEST_EVENTS];
+static int catch_up_event_count;
+
+static uint8_t catch_up_read_button(struct button_obj_t *btn) {
+    catch_up_read_count++;
+    return test_framework_mock_read_button(btn);
+}
+
+static void catch_up_event_callback(struct button_obj_t *btn, bits_btn_result_t result) {
+    if (catch_up_event_count < MAX_TEST_EVENTS) {
+        catch_up_event_ticks[catch_up_event_count++] = bits_button_get_tick();
+    }
+    test_framework_event_callback(btn, result);
+}
+
+static void catch_up_init(void) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t btn;
+    button_obj_t init_btn = BITS_BUTTON_INIT(1, 1, &param);
+    btn = init_btn;
+
+    bits_btn_config_t config = {
+        .btns = &btn,
+        .btns_cnt = 1,
+        .read_button_level_func = catch_up_read_button,
+        .bits_btn_result_cb = catch_up_event_callback,
+        .bits_btn_debug_printf = NULL
+    };
+
+    test_framework_reset();
+    catch_up_event_count = 0;
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+void test_ticks_elapsed_catch_up(void) {
+    printf("\n=== 测试停顿后的批量追赶 ===\n");
+
+    const uint32_t stall_ticks = time_ms_to_ticks(3500);
+    static uint32_t polled_ticks[MAX_TEST_EVENTS];
+
+    // 参考：逐tick轮询
+    catch_up_init();
+    mock_button_press(1);
+    time_simulate_ticks(1 + stall_ticks);
+    int polled_count = catch_up_event_count;
+    memcpy(polled_ticks, catch_up_event_ticks, sizeof(polled_ticks));
+
+    // 追赶：一次调用推进整个停顿区间
+    catch_up_init();
+    mock_button_press(1);
+    bits_button_ticks();
+    catch_up_read_count = 0;
+    bits_button_ticks_elapsed(stall_ticks);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, catch_up_read_count, "追赶期间只应读取一次输入");
+    TEST_ASSERT_EQUAL_INT(polled_count, catch_up_event_count);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(polled_ticks, catch_up_event_ticks, polled_count);
+    ASSERT_LONG_PRESS_COUNT(1, 2);
+
+    printf("批量追赶测试通过 (%d 个事件)\n", polled_count);
+}
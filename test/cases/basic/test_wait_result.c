@@ -0,0 +1,104 @@
+/* test_wait_result.c - 阻塞等待按键结果测试 */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#ifdef BITS_BTN_ENABLE_WAIT
+#include <pthread.h>
+#include <time.h>
+
+// ==================== 辅助函数 ====================
+
+static bits_btn_result_t waiter_result;
+static atomic_int waiter_done;
+static uint8_t waiter_read;
+
+static void *wait_thread(void *arg) {
+    uint32_t timeout_ms = *(const uint32_t *)arg;
+    waiter_read = bits_button_wait_key_result(&waiter_result, timeout_ms);
+    atomic_store(&waiter_done, 1);
+    return NULL;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void wait_init(void) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t buttons[1];
+    buttons[0] = (button_obj_t)BITS_BUTTON_INIT(1, 1, &param);
+    bits_btn_config_t config = {
+        .btns = buttons,
+        .btns_cnt = ARRAY_SIZE(buttons),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+// ==================== 阻塞等待测试 ====================
+
+void test_wait_key_result_timeout(void) {
+    printf("\n=== 测试阻塞等待超时 ===\n");
+
+    wait_init();
+    bits_btn_result_t result;
+
+    // 超时为0时只尝试读取
+    TEST_ASSERT_FALSE(bits_button_wait_key_result(&result, 0));
+
+    double start = now_ms();
+    TEST_ASSERT_FALSE(bits_button_wait_key_result(&result, 30));
+    double elapsed = now_ms() - start;
+    printf("等待30ms超时，实际 %.1f ms\n", elapsed);
+    TEST_ASSERT_TRUE(elapsed >= 29.0);
+
+    // 缓冲区已有结果时立即返回
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    TEST_ASSERT_TRUE(bits_button_wait_key_result(&result, BITS_BTN_WAIT_FOREVER));
+    TEST_ASSERT_EQUAL_UINT16(1, result.key_id);
+    TEST_ASSERT_EQUAL(BTN_EVENT_FINISH, result.event);
+
+    printf("阻塞等待超时测试通过\n");
+}
+
+void test_wait_key_result_wakeup(void) {
+    printf("\n=== 测试阻塞等待被生产者唤醒 ===\n");
+
+    wait_init();
+    static const uint32_t forever = BITS_BTN_WAIT_FOREVER;
+    atomic_store(&waiter_done, 0);
+    waiter_read = 0;
+
+    pthread_t waiter;
+    TEST_ASSERT_EQUAL(0, pthread_create(&waiter, NULL, wait_thread, (void *)&forever));
+
+    // 给读者时间睡下，缓冲区为空时它不能返回
+    struct timespec delay = {0, 20 * 1000000L};
+    nanosleep(&delay, NULL);
+    TEST_ASSERT_EQUAL(0, atomic_load(&waiter_done));
+
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_time_window_end();
+    pthread_join(waiter, NULL);
+
+    TEST_ASSERT_EQUAL_UINT8(1, waiter_read);
+    TEST_ASSERT_EQUAL_UINT16(1, waiter_result.key_id);
+    TEST_ASSERT_EQUAL(BTN_EVENT_FINISH, waiter_result.event);
+    TEST_ASSERT_TRUE(bits_btn_is_buffer_empty());
+
+    printf("阻塞等待被生产者唤醒测试通过\n");
+}
+
+#endif
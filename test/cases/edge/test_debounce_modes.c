@@ -0,0 +1,229 @@
+/* test_debounce_modes.c - 消抖策略测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/mock_utils.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+// ==================== 辅助函数 ====================
+
+static button_obj_t debounce_btns[2];
+
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+static const bits_btn_obj_param_t debounce_param = TEST_DEFAULT_PARAM();
+
+static void debounce_init(bits_btn_debounce_mode_t mode) {
+    button_obj_t btn1 = BITS_BUTTON_INIT(1, 1, &debounce_param);
+    button_obj_t btn2 = BITS_BUTTON_INIT(2, 1, &debounce_param);
+    debounce_btns[0] = btn1;
+    debounce_btns[1] = btn2;
+
+    bits_btn_config_t config = {
+        .btns = debounce_btns,
+        .btns_cnt = ARRAY_SIZE(debounce_btns),
+        .read_button_level_func = test_framework_mock_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .bits_btn_debug_printf = NULL,
+        .debounce_mode = mode
+    };
+
+    test_framework_reset();
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+// 按下按键1的同时让按键2每个tick抖动一次，返回按键1 PRESSED 出现前经过的tick数
+static uint32_t press_while_other_bounces(uint32_t max_ticks) {
+    mock_button_press(1);
+    for (uint32_t tick = 1; tick <= max_ticks; tick++) {
+        mock_set_button_state(2, tick & 1U);
+        bits_button_ticks();
+        if (assert_find_event(1, BTN_EVENT_PRESSED) != NULL) {
+            return tick;
+        }
+    }
+    return max_ticks + 1;
+}
+#endif
+
+// ==================== 按键独立消抖测试 ====================
+
+void test_per_key_debounce_isolation(void) {
+    printf("\n=== 测试按键独立消抖 ===\n");
+
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    const uint32_t debounce_ticks = (BITS_BTN_DEBOUNCE_TIME_MS + BITS_BTN_TICKS_INTERVAL - 1) / BITS_BTN_TICKS_INTERVAL;
+    const uint32_t max_ticks = time_ms_to_ticks(300);
+
+    // 全局消抖：按键2持续抖动会一直冻结按键1
+    debounce_init(BITS_BTN_DEBOUNCE_GLOBAL);
+    TEST_ASSERT_EQUAL_UINT32(max_ticks + 1, press_while_other_bounces(max_ticks));
+
+    // 独立消抖：按键1只等待自己的消抖时间
+    debounce_init(BITS_BTN_DEBOUNCE_PER_KEY);
+    TEST_ASSERT_EQUAL_UINT32(debounce_ticks + 1, press_while_other_bounces(max_ticks));
+    ASSERT_EVENT_NOT_EXISTS(2, BTN_EVENT_PRESSED);
+
+    // 松开后按键1正常完成单击
+    mock_button_release(1);
+    mock_button_release(2);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+
+    printf("按键独立消抖测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_PER_KEY_DEBOUNCE\n");
+#endif
+}
+
+void test_per_key_debounce_filters_bounce(void) {
+    printf("\n=== 测试独立消抖过滤抖动 ===\n");
+
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    debounce_init(BITS_BTN_DEBOUNCE_PER_KEY);
+
+    // 短于消抖时间的毛刺不应产生事件
+    for (int i = 0; i < 5; i++) {
+        mock_button_press(1);
+        time_simulate_pass(10);
+        mock_button_release(1);
+        time_simulate_pass(10);
+    }
+    time_simulate_time_window_end();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, test_framework_get_event_count(), "抖动不应产生事件");
+
+    // 两个按键交错双击互不影响
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    mock_button_press(2);
+    time_simulate_pass(20);
+    mock_button_click(1, STANDARD_CLICK_TIME_MS);
+    time_simulate_pass(STANDARD_CLICK_TIME_MS);
+    mock_button_release(2);
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+
+    ASSERT_EVENT_WITH_VALUE(1, BTN_EVENT_FINISH, BITS_BTN_DOUBLE_CLICK_KV);
+    ASSERT_EVENT_WITH_VALUE(2, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+
+    // 非法的消抖模式应被拒绝
+    bits_btn_config_t config = {
+        .btns = debounce_btns,
+        .btns_cnt = ARRAY_SIZE(debounce_btns),
+        .read_button_level_func = test_framework_mock_read_button,
+        .debounce_mode = (bits_btn_debounce_mode_t)99
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init(&config));
+
+    printf("独立消抖过滤抖动测试通过\n");
+#else
+    // 未编译的消抖模式同样被拒绝
+    bits_btn_config_t config = {
+        .btns = debounce_btns,
+        .btns_cnt = ARRAY_SIZE(debounce_btns),
+        .read_button_level_func = test_framework_mock_read_button,
+        .debounce_mode = BITS_BTN_DEBOUNCE_PER_KEY
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init(&config));
+    printf("跳过：未定义BITS_BTN_ENABLE_PER_KEY_DEBOUNCE\n");
+#endif
+}
+
+// ==================== 垂直计数器差分测试 ====================
+
+#if defined(BITS_BTN_ENABLE_PER_KEY_DEBOUNCE) && defined(BITS_BTN_ENABLE_VERTICAL_DEBOUNCE)
+#define DIFF_KEY_COUNT      (BITS_BTN_MAX_BUTTONS < 40 ? BITS_BTN_MAX_BUTTONS : 40)
+#define DIFF_MAX_EVENTS     8192
+
+typedef struct {
+    button_obj_t btns[DIFF_KEY_COUNT];
+    bits_btn_result_t events[DIFF_MAX_EVENTS];
+    int event_count;
+} diff_log_t;
+
+static diff_log_t diff_logs[2];
+static bits_btn_mask_t diff_raw_mask;
+
+static bits_btn_mask_t diff_read_mask(void) {
+    return diff_raw_mask;
+}
+
+static void diff_event_callback(struct button_obj_t *btn, bits_btn_result_t result) {
+    diff_log_t *log = (btn >= diff_logs[1].btns && btn < diff_logs[1].btns + DIFF_KEY_COUNT) ? &diff_logs[1] : &diff_logs[0];
+    if (log->event_count < DIFF_MAX_EVENTS) {
+        log->events[log->event_count++] = result;
+    }
+}
+
+static uint32_t diff_rand_state = 0x12345678;
+
+static uint32_t diff_rand(void) {
+    diff_rand_state ^= diff_rand_state << 13;
+    diff_rand_state ^= diff_rand_state >> 17;
+    diff_rand_state ^= diff_rand_state << 5;
+    return diff_rand_state;
+}
+#endif
+
+void test_vertical_debounce_matches_per_key(void) {
+    printf("\n=== 测试垂直计数器与独立计数器等价 ===\n");
+
+#if defined(BITS_BTN_ENABLE_PER_KEY_DEBOUNCE) && defined(BITS_BTN_ENABLE_VERTICAL_DEBOUNCE)
+    static bits_button_t instances[2];
+    const bits_btn_debounce_mode_t modes[2] = {BITS_BTN_DEBOUNCE_PER_KEY, BITS_BTN_DEBOUNCE_VERTICAL};
+    uint8_t intended[DIFF_KEY_COUNT] = {0};
+    const bits_btn_mask_t zero_mask = BITS_BTN_MASK_ZERO_INIT;
+
+    diff_raw_mask = zero_mask;
+    for (int n = 0; n < 2; n++) {
+        diff_logs[n].event_count = 0;
+        for (uint16_t i = 0; i < DIFF_KEY_COUNT; i++) {
+            button_obj_t btn = BITS_BUTTON_INIT(i, 1, &debounce_param);
+            diff_logs[n].btns[i] = btn;
+        }
+
+        bits_btn_config_t config = {
+            .btns = diff_logs[n].btns,
+            .btns_cnt = DIFF_KEY_COUNT,
+            .bits_btn_result_cb = diff_event_callback,
+            .read_button_mask_func = diff_read_mask,
+            .debounce_mode = modes[n]
+        };
+        TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&instances[n], &config));
+    }
+
+    // 每个按键按各自周期切换目标电平，并叠加随机抖动
+    for (uint32_t tick = 0; tick < 10000; tick++) {
+        bits_btn_mask_t raw = BITS_BTN_MASK_ZERO_INIT;
+        for (uint16_t i = 0; i < DIFF_KEY_COUNT; i++) {
+            if (tick % (37U + 11U * i) == 0) {
+                intended[i] ^= 1U;
+            }
+            uint8_t level = intended[i];
+            if ((diff_rand() & 7U) == 0) {
+                level ^= 1U;
+            }
+            if (level) {
+                BITS_BTN_MASK_SET_BIT(raw, i);
+            }
+        }
+        diff_raw_mask = raw;
+
+        bits_button_ticks_ctx(&instances[0]);
+        bits_button_ticks_ctx(&instances[1]);
+    }
+
+    TEST_ASSERT_TRUE(diff_logs[0].event_count > 100 && diff_logs[0].event_count < DIFF_MAX_EVENTS);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(diff_logs[0].event_count, diff_logs[1].event_count, "事件数量应一致");
+    for (int i = 0; i < diff_logs[0].event_count; i++) {
+        TEST_ASSERT_EQUAL_UINT16(diff_logs[0].events[i].key_id, diff_logs[1].events[i].key_id);
+        TEST_ASSERT_EQUAL_UINT8(diff_logs[0].events[i].event, diff_logs[1].events[i].event);
+        TEST_ASSERT_EQUAL_UINT32(diff_logs[0].events[i].key_value, diff_logs[1].events[i].key_value);
+    }
+
+    printf("垂直计数器差分测试通过 (%d 个按键, %d 个事件)\n", (int)DIFF_KEY_COUNT, diff_logs[0].event_count);
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_PER_KEY_DEBOUNCE或BITS_BTN_ENABLE_VERTICAL_DEBOUNCE\n");
+#endif
+}
@@ -328,7 +328,7 @@ void test_combo_button_keys_invalid(void) {
         .suppress = 1,
         .key_count = 2,
         .key_single_ids = NULL,  // 无效配置
-        .combo_mask = 0,
+        .combo_mask = BITS_BTN_MASK_ZERO_INIT,
         .btn = BITS_BUTTON_INIT(100, 1, &param)
     };
 
@@ -353,7 +353,7 @@ void test_combo_button_keys_invalid(void) {
         .suppress = 1,
         .key_count = 0,  // 无效配置
         .key_single_ids = combo_keys,
-        .combo_mask = 0,
+        .combo_mask = BITS_BTN_MASK_ZERO_INIT,
         .btn = BITS_BUTTON_INIT(100, 1, &param)
     };
 
@@ -0,0 +1,351 @@
+/* test_state_engines.c - 状态机引擎差分测试 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+// ==================== 差分测试框架 ====================
+
+// 按键数量不是向量宽度的整数倍，覆盖SIMD的尾部处理
+#define ENGINE_KEY_COUNT    (BITS_BTN_MAX_BUTTONS < 27 ? BITS_BTN_MAX_BUTTONS : 27)
+#define ENGINE_TICKS        25000U
+#define ENGINE_MAX_EVENTS   16384
+
+typedef struct {
+    button_obj_t btns[ENGINE_KEY_COUNT];
+    button_obj_combo_t combos[2];
+    bits_btn_result_t events[ENGINE_MAX_EVENTS];
+    int event_count;
+} engine_log_t;
+
+static engine_log_t engine_logs[2];
+static bits_btn_mask_t engine_raw_mask;
+
+static bits_btn_mask_t engine_read_mask(void) {
+    return engine_raw_mask;
+}
+
+// switch以外的引擎都基于表驱动引擎
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+// 不同按键使用不同参数，其中包含不能被tick间隔整除的时间
+static const bits_btn_obj_param_t engine_params[] = {
+    TEST_DEFAULT_PARAM(),
+    {.short_press_time_ms = 200, .long_press_start_time_ms = 603,
+     .long_press_period_triger_ms = 252, .time_window_time_ms = 197},
+    {.short_press_time_ms = 300, .long_press_start_time_ms = 1500,
+     .long_press_period_triger_ms = 500, .time_window_time_ms = 400},
+};
+
+#ifdef BITS_BTN_ENABLE_PATTERNS
+// 部分按键注册键值模式，覆盖各引擎的提前结束
+static const state_bits_type_t engine_patterns_single[] = {BITS_BTN_SINGLE_CLICK_KV};
+static const state_bits_type_t engine_patterns_multi[] = {BITS_BTN_SINGLE_CLICK_KV, BITS_BTN_DOUBLE_CLICK_KV, 0b110};
+static const bits_btn_pattern_set_t engine_pattern_sets[] = {
+    {.key_id = 1, .pattern_cnt = ARRAY_SIZE(engine_patterns_single), .patterns = engine_patterns_single},
+    {.key_id = 6, .pattern_cnt = ARRAY_SIZE(engine_patterns_multi), .patterns = engine_patterns_multi},
+    {.key_id = 7, .pattern_cnt = ARRAY_SIZE(engine_patterns_single), .patterns = engine_patterns_single},
+    {.key_id = 100, .pattern_cnt = ARRAY_SIZE(engine_patterns_multi), .patterns = engine_patterns_multi},
+};
+#endif
+
+static uint16_t engine_combo_keys_a[] = {0, 1};
+static uint16_t engine_combo_keys_b[] = {2, 3, 4};
+
+static void engine_event_callback(struct button_obj_t *btn, bits_btn_result_t result) {
+    engine_log_t *log = &engine_logs[0];
+    if ((btn >= engine_logs[1].btns && btn < engine_logs[1].btns + ENGINE_KEY_COUNT)
+        || (btn >= &engine_logs[1].combos[0].btn && btn <= &engine_logs[1].combos[1].btn)) {
+        log = &engine_logs[1];
+    }
+    if (log->event_count < ENGINE_MAX_EVENTS) {
+        log->events[log->event_count++] = result;
+    }
+}
+
+static uint32_t engine_rand_state;
+
+static uint32_t engine_rand(void) {
+    engine_rand_state ^= engine_rand_state << 13;
+    engine_rand_state ^= engine_rand_state >> 17;
+    engine_rand_state ^= engine_rand_state << 5;
+    return engine_rand_state;
+}
+
+// uniform_param 非空时所有单按键共用这一套参数（位切片引擎的要求），组合按键参数不受限制
+static void engine_init(bits_button_t *instance, engine_log_t *log, bits_btn_engine_t engine,
+                        bits_btn_debounce_mode_t debounce_mode, const bits_btn_obj_param_t *uniform_param) {
+    log->event_count = 0;
+    for (uint16_t i = 0; i < ENGINE_KEY_COUNT; i++) {
+        const bits_btn_obj_param_t *param = uniform_param ? uniform_param : &engine_params[i % ARRAY_SIZE(engine_params)];
+        button_obj_t btn = BITS_BUTTON_INIT(i, 1, param);
+        log->btns[i] = btn;
+    }
+    button_obj_combo_t combo_a = BITS_BUTTON_COMBO_INIT(100, 1, &engine_params[0], engine_combo_keys_a, 2, 1);
+    button_obj_combo_t combo_b = BITS_BUTTON_COMBO_INIT(101, 1, &engine_params[2], engine_combo_keys_b, 3, 0);
+    log->combos[0] = combo_a;
+    log->combos[1] = combo_b;
+
+    bits_btn_config_t config = {
+        .btns = log->btns,
+        .btns_cnt = ENGINE_KEY_COUNT,
+        .btns_combo = log->combos,
+        .btns_combo_cnt = 2,
+        .bits_btn_result_cb = engine_event_callback,
+        .read_button_mask_func = engine_read_mask,
+        .debounce_mode = debounce_mode,
+        .engine = engine,
+#ifdef BITS_BTN_ENABLE_PATTERNS
+        .pattern_sets = engine_pattern_sets,
+        .pattern_sets_cnt = ARRAY_SIZE(engine_pattern_sets)
+#endif
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(instance, &config));
+}
+
+// 参考引擎与被测引擎并排运行同一段随机输入，中途重置一次状态，逐个比较事件
+static void engine_run_differential(bits_btn_engine_t engine, bits_btn_debounce_mode_t debounce_mode,
+                                    const bits_btn_obj_param_t *uniform_param) {
+    static bits_button_t instances[2];
+    uint32_t hold_until[ENGINE_KEY_COUNT] = {0};
+    uint8_t level[ENGINE_KEY_COUNT] = {0};
+    const bits_btn_mask_t zero_mask = BITS_BTN_MASK_ZERO_INIT;
+
+    engine_rand_state = 0x2468ACE1;
+    engine_raw_mask = zero_mask;
+    engine_init(&instances[0], &engine_logs[0], BITS_BTN_ENGINE_SWITCH, debounce_mode, uniform_param);
+    engine_init(&instances[1], &engine_logs[1], engine, debounce_mode, uniform_param);
+
+    // 每个按键随机选择按住/松开时长：短按、连击间隔、长按保持都会出现
+    for (uint32_t tick = 0; tick < ENGINE_TICKS; tick++) {
+        bits_btn_mask_t raw = BITS_BTN_MASK_ZERO_INIT;
+        for (uint16_t i = 0; i < ENGINE_KEY_COUNT; i++) {
+            if (tick >= hold_until[i]) {
+                level[i] ^= 1U;
+                hold_until[i] = tick + 1 + engine_rand() % (level[i] ? 500U : 120U);
+            }
+            if (level[i]) {
+                BITS_BTN_MASK_SET_BIT(raw, i);
+            }
+        }
+        engine_raw_mask = raw;
+
+        if (tick == ENGINE_TICKS / 2) {
+            bits_button_reset_states_ctx(&instances[0]);
+            bits_button_reset_states_ctx(&instances[1]);
+        }
+        bits_button_ticks_ctx(&instances[0]);
+        bits_button_ticks_ctx(&instances[1]);
+    }
+
+    TEST_ASSERT_TRUE(engine_logs[0].event_count > 100 && engine_logs[0].event_count < ENGINE_MAX_EVENTS);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(engine_logs[0].event_count, engine_logs[1].event_count, "事件数量应一致");
+    for (int i = 0; i < engine_logs[0].event_count; i++) {
+        TEST_ASSERT_EQUAL_UINT16(engine_logs[0].events[i].key_id, engine_logs[1].events[i].key_id);
+        TEST_ASSERT_EQUAL_UINT8(engine_logs[0].events[i].event, engine_logs[1].events[i].event);
+        TEST_ASSERT_EQUAL_UINT32(engine_logs[0].events[i].key_value, engine_logs[1].events[i].key_value);
+        TEST_ASSERT_EQUAL_UINT16(engine_logs[0].events[i].long_press_period_trigger_cnt,
+                                 engine_logs[1].events[i].long_press_period_trigger_cnt);
+    }
+
+    printf("差分通过 (引擎 %d, 消抖 %d, %d 个事件)\n", (int)engine, (int)debounce_mode, engine_logs[0].event_count);
+}
+#endif
+
+// ==================== 表驱动引擎测试 ====================
+
+void test_table_engine_matches_switch(void) {
+    printf("\n=== 测试表驱动引擎与switch引擎等价 ===\n");
+
+    // 非法的引擎应被拒绝
+    bits_btn_config_t config = {
+        .btns = engine_logs[0].btns,
+        .btns_cnt = ENGINE_KEY_COUNT,
+        .read_button_mask_func = engine_read_mask,
+        .engine = (bits_btn_engine_t)99
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init(&config));
+
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+    engine_run_differential(BITS_BTN_ENGINE_TABLE, BITS_BTN_DEBOUNCE_GLOBAL, NULL);
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_TABLE, BITS_BTN_DEBOUNCE_PER_KEY, NULL);
+#endif
+
+    printf("表驱动引擎差分测试通过\n");
+#else
+    // 未编译的引擎同样被拒绝
+    config.engine = BITS_BTN_ENGINE_TABLE;
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_INVALID_PARAM, bits_button_init(&config));
+    printf("跳过：未定义BITS_BTN_ENABLE_TABLE_ENGINE\n");
+#endif
+}
+
+// ==================== 位切片引擎测试 ====================
+
+void test_bitslice_engine_matches_switch(void) {
+    printf("\n=== 测试位切片引擎与switch引擎等价 ===\n");
+
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    engine_run_differential(BITS_BTN_ENGINE_BITSLICE, BITS_BTN_DEBOUNCE_GLOBAL, &engine_params[1]);
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_BITSLICE, BITS_BTN_DEBOUNCE_PER_KEY, &engine_params[1]);
+#endif
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_BITSLICE, BITS_BTN_DEBOUNCE_VERTICAL, &engine_params[1]);
+#endif
+
+    // 参数内容相同但指针不同仍可使用
+    static bits_btn_obj_param_t param_copy;
+    param_copy = engine_params[1];
+    engine_logs[0].btns[1].param = &param_copy;
+    bits_btn_config_t config = {
+        .btns = engine_logs[0].btns,
+        .btns_cnt = ENGINE_KEY_COUNT,
+        .read_button_mask_func = engine_read_mask,
+        .engine = BITS_BTN_ENGINE_BITSLICE
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+
+    // 单按键参数不一致时应被拒绝
+    engine_logs[0].btns[1].param = &engine_params[0];
+    TEST_ASSERT_EQUAL(BITS_BTN_ERR_PARAM_MISMATCH, bits_button_init(&config));
+
+    printf("位切片引擎差分测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_BITSLICE_ENGINE\n");
+#endif
+}
+
+#if defined(BITS_BTN_ENABLE_BITSLICE_ENGINE) || defined(BITS_BTN_ENABLE_SOA_ENGINE) || defined(BITS_BTN_ENABLE_WHEEL_ENGINE)
+// 按住一个按键跨越长按和多次重复，被测引擎通过批量推进一次跳过多个tick
+static void engine_run_catch_up(bits_btn_engine_t engine, const bits_btn_obj_param_t *uniform_param) {
+    static bits_button_t instances[2];
+    const bits_btn_mask_t zero_mask = BITS_BTN_MASK_ZERO_INIT;
+    bits_btn_mask_t held = BITS_BTN_MASK_ZERO_INIT;
+
+    engine_raw_mask = zero_mask;
+    engine_init(&instances[0], &engine_logs[0], BITS_BTN_ENGINE_SWITCH, BITS_BTN_DEBOUNCE_GLOBAL, uniform_param);
+    engine_init(&instances[1], &engine_logs[1], engine, BITS_BTN_DEBOUNCE_GLOBAL, uniform_param);
+
+    BITS_BTN_MASK_SET_BIT(held, 5);
+    engine_raw_mask = held;
+    for (uint32_t tick = 0; tick < 1000; tick++) {
+        bits_button_ticks_ctx(&instances[0]);
+    }
+    bits_button_ticks_ctx(&instances[1]);
+    bits_button_ticks_elapsed_ctx(&instances[1], 999);
+
+    // 松开的边沿唤醒一次，再睡过时间窗口
+    engine_raw_mask = zero_mask;
+    for (uint32_t tick = 0; tick < 200; tick++) {
+        bits_button_ticks_ctx(&instances[0]);
+    }
+    bits_button_ticks_elapsed_ctx(&instances[1], 1);
+    bits_button_ticks_elapsed_ctx(&instances[1], 199);
+
+    TEST_ASSERT_TRUE(engine_logs[0].event_count > 5);
+    TEST_ASSERT_EQUAL_INT(engine_logs[0].event_count, engine_logs[1].event_count);
+    for (int i = 0; i < engine_logs[0].event_count; i++) {
+        TEST_ASSERT_EQUAL_UINT8(engine_logs[0].events[i].event, engine_logs[1].events[i].event);
+        TEST_ASSERT_EQUAL_UINT32(engine_logs[0].events[i].key_value, engine_logs[1].events[i].key_value);
+        TEST_ASSERT_EQUAL_UINT16(engine_logs[0].events[i].long_press_period_trigger_cnt,
+                                 engine_logs[1].events[i].long_press_period_trigger_cnt);
+    }
+
+    printf("批量推进通过 (引擎 %d, %d 个事件)\n", (int)engine, engine_logs[0].event_count);
+}
+#endif
+
+void test_bitslice_engine_ticks_elapsed(void) {
+    printf("\n=== 测试位切片引擎批量推进 ===\n");
+
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+    engine_run_catch_up(BITS_BTN_ENGINE_BITSLICE, &engine_params[1]);
+
+    printf("位切片引擎批量推进测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_BITSLICE_ENGINE\n");
+#endif
+}
+
+// ==================== 结构数组引擎测试 ====================
+
+void test_soa_engine_matches_switch(void) {
+    printf("\n=== 测试结构数组引擎与switch引擎等价 ===\n");
+
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+    engine_run_differential(BITS_BTN_ENGINE_SOA, BITS_BTN_DEBOUNCE_GLOBAL, NULL);
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_SOA, BITS_BTN_DEBOUNCE_PER_KEY, NULL);
+#endif
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_SOA, BITS_BTN_DEBOUNCE_VERTICAL, NULL);
+#endif
+    engine_run_catch_up(BITS_BTN_ENGINE_SOA, NULL);
+
+    printf("结构数组引擎差分测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_SOA_ENGINE\n");
+#endif
+}
+
+// ==================== 时间轮引擎测试 ====================
+
+void test_wheel_engine_matches_switch(void) {
+    printf("\n=== 测试时间轮引擎与switch引擎等价 ===\n");
+
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+    engine_run_differential(BITS_BTN_ENGINE_WHEEL, BITS_BTN_DEBOUNCE_GLOBAL, NULL);
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_WHEEL, BITS_BTN_DEBOUNCE_PER_KEY, NULL);
+#endif
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    engine_run_differential(BITS_BTN_ENGINE_WHEEL, BITS_BTN_DEBOUNCE_VERTICAL, NULL);
+#endif
+    engine_run_catch_up(BITS_BTN_ENGINE_WHEEL, NULL);
+
+    printf("时间轮引擎差分测试通过\n");
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_WHEEL_ENGINE\n");
+#endif
+}
+
+void test_wheel_engine_long_timeouts(void) {
+    printf("\n=== 测试时间轮引擎长超时级联 ===\n");
+
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+    // 超时接近uint16_t上限，定时器要挂在最高层并逐层级联下来
+    static const bits_btn_obj_param_t long_param = {
+        .short_press_time_ms = 300, .long_press_start_time_ms = 60000,
+        .long_press_period_triger_ms = 65535, .time_window_time_ms = 30000
+    };
+    static bits_button_t instances[2];
+    const bits_btn_mask_t zero_mask = BITS_BTN_MASK_ZERO_INIT;
+    bits_btn_mask_t held = BITS_BTN_MASK_ZERO_INIT;
+
+    BITS_BTN_MASK_SET_BIT(held, 5);
+    engine_raw_mask = zero_mask;
+    engine_init(&instances[0], &engine_logs[0], BITS_BTN_ENGINE_SWITCH, BITS_BTN_DEBOUNCE_GLOBAL, &long_param);
+    engine_init(&instances[1], &engine_logs[1], BITS_BTN_ENGINE_WHEEL, BITS_BTN_DEBOUNCE_GLOBAL, &long_param);
+
+    // 按住跨过长按和两次重复，松开后的时间窗口跨过第65536个tick
+    for (uint32_t tick = 0; tick < 75000; tick++) {
+        engine_raw_mask = (tick >= 20000 && tick < 65000) ? held : zero_mask;
+        bits_button_ticks_ctx(&instances[0]);
+        bits_button_ticks_ctx(&instances[1]);
+    }
+
+    TEST_ASSERT_TRUE(engine_logs[0].event_count >= 5);
+    TEST_ASSERT_EQUAL_INT(engine_logs[0].event_count, engine_logs[1].event_count);
+    for (int i = 0; i < engine_logs[0].event_count; i++) {
+        TEST_ASSERT_EQUAL_UINT8(engine_logs[0].events[i].event, engine_logs[1].events[i].event);
+        TEST_ASSERT_EQUAL_UINT32(engine_logs[0].events[i].key_value, engine_logs[1].events[i].key_value);
+        TEST_ASSERT_EQUAL_UINT16(engine_logs[0].events[i].long_press_period_trigger_cnt,
+                                 engine_logs[1].events[i].long_press_period_trigger_cnt);
+    }
+
+    printf("时间轮引擎长超时测试通过 (%d 个事件)\n", engine_logs[0].event_count);
+#else
+    printf("跳过：未定义BITS_BTN_ENABLE_WHEEL_ENGINE\n");
+#endif
+}
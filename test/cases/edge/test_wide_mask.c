@@ -0,0 +1,123 @@
+/* test_wide_mask.c - 多字按键掩码测试（BITS_BTN_MAX_BUTTONS > 32） */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "utils/time_utils.h"
+#include "utils/assert_utils.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#if BITS_BTN_MAX_BUTTONS > 32
+
+#define WIDE_BTN_COUNT  BITS_BTN_MAX_BUTTONS
+
+// 宽掩码测试使用独立的电平表，按键ID与数组下标一一对应
+static uint8_t wide_levels[WIDE_BTN_COUNT];
+static button_obj_t wide_buttons[WIDE_BTN_COUNT];
+
+static uint8_t wide_read_button(struct button_obj_t *btn) {
+    return btn->key_id < WIDE_BTN_COUNT ? wide_levels[btn->key_id] : 0;
+}
+
+static bits_btn_mask_t wide_read_button_mask(void) {
+    bits_btn_mask_t raw = BITS_BTN_MASK_ZERO_INIT;
+    for (uint16_t i = 0; i < WIDE_BTN_COUNT; i++) {
+        if (wide_levels[i]) {
+            BITS_BTN_MASK_SET_BIT(raw, i);
+        }
+    }
+    return raw;
+}
+
+static void wide_init(button_obj_combo_t *combos, uint16_t combo_cnt, uint8_t use_mask_reader) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+
+    for (uint16_t i = 0; i < WIDE_BTN_COUNT; i++) {
+        button_obj_t btn = BITS_BUTTON_INIT(i, 1, &param);
+        wide_buttons[i] = btn;
+        wide_levels[i] = 0;
+    }
+
+    bits_btn_config_t config = {
+        .btns = wide_buttons,
+        .btns_cnt = WIDE_BTN_COUNT,
+        .btns_combo = combos,
+        .btns_combo_cnt = combo_cnt,
+        .read_button_level_func = use_mask_reader ? NULL : wide_read_button,
+        .bits_btn_result_cb = test_framework_event_callback,
+        .bits_btn_debug_printf = NULL,
+        .read_button_mask_func = use_mask_reader ? wide_read_button_mask : NULL
+    };
+
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init(&config));
+}
+
+static void wide_click(uint16_t key_id) {
+    wide_levels[key_id] = 1;
+    time_simulate_debounce_delay();
+    time_simulate_pass(STANDARD_CLICK_TIME_MS);
+    wide_levels[key_id] = 0;
+    time_simulate_debounce_delay();
+}
+
+#endif
+
+// ==================== 高位按键测试 ====================
+
+void test_wide_mask_high_index_button(void) {
+    printf("\n=== 测试宽掩码高位按键 ===\n");
+
+#if BITS_BTN_MAX_BUTTONS > 32
+    // 逐键读取回调
+    wide_init(NULL, 0, 0);
+    wide_click(WIDE_BTN_COUNT - 28);
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(WIDE_BTN_COUNT - 28, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+    ASSERT_EVENT_NOT_EXISTS(WIDE_BTN_COUNT - 60, BTN_EVENT_PRESSED);
+
+    // 批量读取回调，跨越多个掩码字
+    test_framework_clear_events();
+    wide_init(NULL, 0, 1);
+    wide_click(WIDE_BTN_COUNT - 1);
+    wide_click(WIDE_BTN_COUNT - 1);
+    time_simulate_time_window_end();
+    ASSERT_EVENT_WITH_VALUE(WIDE_BTN_COUNT - 1, BTN_EVENT_FINISH, BITS_BTN_DOUBLE_CLICK_KV);
+
+    printf("宽掩码高位按键测试通过 (%d 个按键)\n", (int)WIDE_BTN_COUNT);
+#else
+    printf("跳过：当前BITS_BTN_MAX_BUTTONS未超过32\n");
+#endif
+}
+
+// ==================== 跨字组合按键测试 ====================
+
+void test_wide_mask_cross_word_combo(void) {
+    printf("\n=== 测试跨掩码字组合按键 ===\n");
+
+#if BITS_BTN_MAX_BUTTONS > 32
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    // 31 和 32 分别位于第0个和第1个掩码字
+    static uint16_t combo_keys[] = {31, 32};
+    button_obj_combo_t combos[] = {
+        BITS_BUTTON_COMBO_INIT(1000, 1, &param, combo_keys, 2, 1)
+    };
+
+    wide_init(combos, ARRAY_SIZE(combos), 1);
+
+    wide_levels[31] = 1;
+    wide_levels[32] = 1;
+    time_simulate_debounce_delay();
+    time_simulate_pass(STANDARD_CLICK_TIME_MS);
+    wide_levels[31] = 0;
+    wide_levels[32] = 0;
+    time_simulate_debounce_delay();
+    time_simulate_time_window_end();
+
+    ASSERT_EVENT_WITH_VALUE(1000, BTN_EVENT_FINISH, BITS_BTN_SINGLE_CLICK_KV);
+    ASSERT_EVENT_NOT_EXISTS(31, BTN_EVENT_PRESSED);
+    ASSERT_EVENT_NOT_EXISTS(32, BTN_EVENT_PRESSED);
+
+    printf("跨掩码字组合按键测试通过\n");
+#else
+    printf("跳过：当前BITS_BTN_MAX_BUTTONS未超过32\n");
+#endif
+}
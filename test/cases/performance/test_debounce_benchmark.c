@@ -0,0 +1,80 @@
+/* test_debounce_benchmark.c - 消抖策略性能基准 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+#include <time.h>
+
+#define BENCH_KEY_COUNT     (BITS_BTN_MAX_BUTTONS < 32 ? BITS_BTN_MAX_BUTTONS : 32)
+#define BENCH_TICKS         200000UL
+
+static bits_btn_mask_t bench_raw_mask;
+static uint32_t bench_rand_state;
+
+static bits_btn_mask_t bench_read_mask(void) {
+    return bench_raw_mask;
+}
+
+static uint32_t bench_rand(void) {
+    bench_rand_state ^= bench_rand_state << 13;
+    bench_rand_state ^= bench_rand_state >> 17;
+    bench_rand_state ^= bench_rand_state << 5;
+    return bench_rand_state;
+}
+
+// 所有按键同时抖动，返回每tick耗时（纳秒）
+static double bench_debounce_mode(bits_btn_debounce_mode_t mode) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t btns[BENCH_KEY_COUNT];
+    static bits_button_t instance;
+
+    for (uint16_t i = 0; i < BENCH_KEY_COUNT; i++) {
+        button_obj_t btn = BITS_BUTTON_INIT(i, 1, &param);
+        btns[i] = btn;
+    }
+
+    bits_btn_config_t config = {
+        .btns = btns,
+        .btns_cnt = BENCH_KEY_COUNT,
+        .read_button_mask_func = bench_read_mask,
+        .debounce_mode = mode
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&instance, &config));
+
+    bench_rand_state = 0x2545F491;
+    clock_t start = clock();
+    for (unsigned long tick = 0; tick < BENCH_TICKS; tick++) {
+        bits_btn_mask_t raw = BITS_BTN_MASK_ZERO_INIT;
+        uint32_t noise = bench_rand() & bench_rand();
+        for (uint16_t i = 0; i < BENCH_KEY_COUNT; i++) {
+            if ((noise >> i) & 1U) {
+                BITS_BTN_MASK_SET_BIT(raw, i);
+            }
+        }
+        bench_raw_mask = raw;
+        bits_button_ticks_ctx(&instance);
+    }
+    clock_t elapsed = clock() - start;
+
+    return (double)elapsed * 1e9 / CLOCKS_PER_SEC / BENCH_TICKS;
+}
+
+void test_debounce_strategy_benchmark(void) {
+    printf("\n=== 消抖策略性能基准 (%d 个按键, %lu 个tick) ===\n", (int)BENCH_KEY_COUNT, BENCH_TICKS);
+
+    double global_ns = bench_debounce_mode(BITS_BTN_DEBOUNCE_GLOBAL);
+    printf("全局时间窗口: %8.1f ns/tick\n", global_ns);
+    TEST_ASSERT_TRUE(global_ns >= 0);
+
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+    double per_key_ns = bench_debounce_mode(BITS_BTN_DEBOUNCE_PER_KEY);
+    printf("独立计数器:   %8.1f ns/tick\n", per_key_ns);
+    TEST_ASSERT_TRUE(per_key_ns >= 0);
+#endif
+
+#ifdef BITS_BTN_ENABLE_VERTICAL_DEBOUNCE
+    double vertical_ns = bench_debounce_mode(BITS_BTN_DEBOUNCE_VERTICAL);
+    printf("垂直计数器:   %8.1f ns/tick\n", vertical_ns);
+    TEST_ASSERT_TRUE(vertical_ns >= 0);
+#endif
+}
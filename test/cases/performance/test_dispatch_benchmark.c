@@ -0,0 +1,61 @@
+/* test_dispatch_benchmark.c - 按键分发性能基准 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+#include <time.h>
+
+#define DISPATCH_BENCH_KEYS     (BITS_BTN_MAX_BUTTONS < 32 ? BITS_BTN_MAX_BUTTONS : 32)
+#define DISPATCH_BENCH_TICKS    200000UL
+
+static bits_btn_mask_t dispatch_bench_mask;
+
+static bits_btn_mask_t dispatch_bench_read_mask(void) {
+    return dispatch_bench_mask;
+}
+
+// 前 active_keys 个按键保持按下，返回每秒可处理的tick数
+static double bench_active_keys(uint16_t active_keys) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t btns[DISPATCH_BENCH_KEYS];
+    static bits_button_t instance;
+    bits_btn_mask_t mask = BITS_BTN_MASK_ZERO_INIT;
+
+    for (uint16_t i = 0; i < DISPATCH_BENCH_KEYS; i++) {
+        button_obj_t btn = BITS_BUTTON_INIT(i, 1, &param);
+        btns[i] = btn;
+        if (i < active_keys) {
+            BITS_BTN_MASK_SET_BIT(mask, i);
+        }
+    }
+    dispatch_bench_mask = mask;
+
+    bits_btn_config_t config = {
+        .btns = btns,
+        .btns_cnt = DISPATCH_BENCH_KEYS,
+        .read_button_mask_func = dispatch_bench_read_mask
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&instance, &config));
+
+    clock_t start = clock();
+    for (unsigned long tick = 0; tick < DISPATCH_BENCH_TICKS; tick++) {
+        bits_button_ticks_ctx(&instance);
+    }
+    clock_t elapsed = clock() - start;
+
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return (double)DISPATCH_BENCH_TICKS * CLOCKS_PER_SEC / elapsed;
+}
+
+void test_dispatch_active_set_benchmark(void) {
+    printf("\n=== 按键分发性能基准 (%d 个按键, %lu 个tick) ===\n", (int)DISPATCH_BENCH_KEYS, DISPATCH_BENCH_TICKS);
+
+    const uint16_t active_counts[] = {0, 1, 2, 8, 16, DISPATCH_BENCH_KEYS};
+    for (size_t i = 0; i < ARRAY_SIZE(active_counts); i++) {
+        double ticks_per_sec = bench_active_keys(active_counts[i]);
+        printf("活动按键 %2d 个: %12.0f ticks/s\n", active_counts[i], ticks_per_sec);
+        TEST_ASSERT_TRUE(ticks_per_sec > 0);
+    }
+}
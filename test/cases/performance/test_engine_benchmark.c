@@ -0,0 +1,130 @@
+/* test_engine_benchmark.c - 状态机引擎性能基准 */
+#include "unity.h"
+#include "core/test_framework.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ENGINE_BENCH_HAS_TSC    1
+#endif
+
+#define ENGINE_BENCH_KEYS       (BITS_BTN_MAX_BUTTONS < 1024 ? BITS_BTN_MAX_BUTTONS : 1024)
+#define ENGINE_BENCH_TICKS      100000UL    // 32个按键以内的tick数，按键更多时按比例减少
+#define ENGINE_BENCH_PATTERN    4096
+
+// 按键各自动作，独立消抖让它们互不冻结；没有编译时退回全局消抖
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+#define ENGINE_BENCH_DEBOUNCE   BITS_BTN_DEBOUNCE_PER_KEY
+#else
+#define ENGINE_BENCH_DEBOUNCE   BITS_BTN_DEBOUNCE_GLOBAL
+#endif
+
+static bits_btn_mask_t engine_bench_pattern[ENGINE_BENCH_PATTERN];
+static bits_btn_mask_t engine_bench_mask;
+
+static bits_btn_mask_t engine_bench_read_mask(void) {
+    return engine_bench_mask;
+}
+
+// 预先生成输入序列，避免把随机数开销计入基准
+static void engine_bench_build_pattern(void) {
+    uint32_t rand_state = 0x9E3779B9;
+    uint32_t hold_until[ENGINE_BENCH_KEYS] = {0};
+    uint8_t level[ENGINE_BENCH_KEYS] = {0};
+
+    for (uint32_t tick = 0; tick < ENGINE_BENCH_PATTERN; tick++) {
+        bits_btn_mask_t raw = BITS_BTN_MASK_ZERO_INIT;
+        for (uint16_t i = 0; i < ENGINE_BENCH_KEYS; i++) {
+            if (tick >= hold_until[i]) {
+                rand_state ^= rand_state << 13;
+                rand_state ^= rand_state >> 17;
+                rand_state ^= rand_state << 5;
+                level[i] ^= 1U;
+                hold_until[i] = tick + 1 + rand_state % (level[i] ? 400U : 100U);
+            }
+            if (level[i]) {
+                BITS_BTN_MASK_SET_BIT(raw, i);
+            }
+        }
+        engine_bench_pattern[tick] = raw;
+    }
+}
+
+typedef struct {
+    double ns_per_tick;
+    double cycles_per_button_tick;
+} engine_bench_result_t;
+
+// 前 key_count 个按键按预生成序列动作，所有按键共用一套参数
+static engine_bench_result_t bench_engine(bits_btn_engine_t engine, uint16_t key_count) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t btns[ENGINE_BENCH_KEYS];
+    static bits_button_t instance;
+    engine_bench_result_t result = {0, 0};
+    unsigned long ticks = key_count <= 32 ? ENGINE_BENCH_TICKS : ENGINE_BENCH_TICKS * 32 / key_count;
+
+    for (uint16_t i = 0; i < key_count; i++) {
+        button_obj_t btn = BITS_BUTTON_INIT(i, 1, &param);
+        btns[i] = btn;
+    }
+
+    bits_btn_config_t config = {
+        .btns = btns,
+        .btns_cnt = key_count,
+        .read_button_mask_func = engine_bench_read_mask,
+        .debounce_mode = ENGINE_BENCH_DEBOUNCE,
+        .engine = engine
+    };
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&instance, &config));
+
+    clock_t start = clock();
+#ifdef ENGINE_BENCH_HAS_TSC
+    unsigned long long tsc_start = __rdtsc();
+#endif
+    for (unsigned long tick = 0; tick < ticks; tick++) {
+        engine_bench_mask = engine_bench_pattern[tick % ENGINE_BENCH_PATTERN];
+        bits_button_ticks_ctx(&instance);
+    }
+#ifdef ENGINE_BENCH_HAS_TSC
+    result.cycles_per_button_tick = (double)(__rdtsc() - tsc_start) / ticks / key_count;
+#endif
+    clock_t elapsed = clock() - start;
+
+    result.ns_per_tick = (double)elapsed * 1e9 / CLOCKS_PER_SEC / ticks;
+    return result;
+}
+
+void test_state_engine_benchmark(void) {
+    printf("\n=== 状态机引擎性能基准 (最多 %d 个按键) ===\n", (int)ENGINE_BENCH_KEYS);
+
+    const struct {
+        bits_btn_engine_t engine;
+        const char *name;
+    } engines[] = {
+        {BITS_BTN_ENGINE_SWITCH,   "switch 引擎"},
+#ifdef BITS_BTN_ENABLE_TABLE_ENGINE
+        {BITS_BTN_ENGINE_TABLE,    "表驱动引擎 "},
+#endif
+#ifdef BITS_BTN_ENABLE_BITSLICE_ENGINE
+        {BITS_BTN_ENGINE_BITSLICE, "位切片引擎 "},
+#endif
+#ifdef BITS_BTN_ENABLE_SOA_ENGINE
+        {BITS_BTN_ENGINE_SOA,      "结构数组引擎"},
+#endif
+#ifdef BITS_BTN_ENABLE_WHEEL_ENGINE
+        {BITS_BTN_ENGINE_WHEEL,    "时间轮引擎 "},
+#endif
+    };
+    const uint16_t key_counts[] = {1, 8, 32, 128, 256, 1024};
+
+    engine_bench_build_pattern();
+    for (size_t i = 0; i < ARRAY_SIZE(engines); i++) {
+        for (size_t k = 0; k < ARRAY_SIZE(key_counts) && key_counts[k] <= ENGINE_BENCH_KEYS; k++) {
+            engine_bench_result_t result = bench_engine(engines[i].engine, key_counts[k]);
+            printf("%s %3d 个按键: %9.1f ns/tick, %8.1f 周期/按键tick\n", engines[i].name,
+                   key_counts[k], result.ns_per_tick, result.cycles_per_button_tick);
+            TEST_ASSERT_TRUE(result.ns_per_tick >= 0);
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include "utils/assert_utils.h"
 #include "config/test_config.h"
 #include "bits_button.h"
+#include <time.h>
 
 // ==================== 测试设置和清理 ====================
 
@@ -164,4 +165,97 @@ void test_memory_usage(void) {
     }
     
     printf("内存使用测试通过: %d个按键同时工作\n", MAX_TEST_BUTTONS);
-}
\ No newline at end of file
+}
+// ==================== 组合键匹配扩展性测试 ====================
+
+#define COMBO_BENCH_KEYS    (BITS_BTN_MAX_BUTTONS < 32 ? BITS_BTN_MAX_BUTTONS : 32)
+#define COMBO_BENCH_TICKS   20000U
+
+static bits_btn_mask_t combo_bench_mask;
+static uint32_t combo_bench_pressed_events;
+
+static bits_btn_mask_t combo_bench_read_mask(void) {
+    return combo_bench_mask;
+}
+
+static void combo_bench_callback(struct button_obj_t *btn, bits_btn_result_t result) {
+    (void)btn;
+    if (result.key_id >= 1000 && result.event == BTN_EVENT_PRESSED) {
+        combo_bench_pressed_events++;
+    }
+}
+
+// 注册 combo_count 个两键组合键，反复随机按下其中一个，返回每tick耗时(ns)
+static double bench_combo_matcher(uint16_t combo_count) {
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t btns[COMBO_BENCH_KEYS];
+    static button_obj_combo_t combos[BITS_BTN_MAX_COMBO_BUTTONS];
+    static uint16_t combo_keys[BITS_BTN_MAX_COMBO_BUTTONS][2];
+    static bits_button_t instance;
+    const bits_btn_mask_t zero_mask = BITS_BTN_MASK_ZERO_INIT;
+    uint32_t rand_state = 0x13579BDF;
+    uint32_t chords = 0;
+
+    for (uint16_t i = 0; i < COMBO_BENCH_KEYS; i++) {
+        btns[i] = (button_obj_t)BITS_BUTTON_INIT(i, 1, &param);
+    }
+    // 组合 c 为按键 a 与 a+d，d 不超过按键数的一半，各组合的按键集合互不相同
+    for (uint16_t c = 0; c < combo_count; c++) {
+        uint16_t a = c % COMBO_BENCH_KEYS;
+        uint16_t d = 1 + (c / COMBO_BENCH_KEYS) % (COMBO_BENCH_KEYS / 2 - 1);
+        combo_keys[c][0] = a;
+        combo_keys[c][1] = (a + d) % COMBO_BENCH_KEYS;
+        combos[c] = (button_obj_combo_t)BITS_BUTTON_COMBO_INIT(1000 + c, 1, &param, combo_keys[c], 2, 1);
+    }
+
+    bits_btn_config_t config = {
+        .btns = btns,
+        .btns_cnt = COMBO_BENCH_KEYS,
+        .btns_combo = combos,
+        .btns_combo_cnt = combo_count,
+        .read_button_mask_func = combo_bench_read_mask,
+        .bits_btn_result_cb = combo_bench_callback
+    };
+    combo_bench_mask = zero_mask;
+    combo_bench_pressed_events = 0;
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&instance, &config));
+
+    // 按住40个tick，再松开100个tick等时间窗口结束
+    clock_t start = clock();
+    for (uint32_t tick = 0; tick < COMBO_BENCH_TICKS; tick++) {
+        uint32_t phase = tick % 140U;
+        if (phase == 0) {
+            rand_state ^= rand_state << 13;
+            rand_state ^= rand_state >> 17;
+            rand_state ^= rand_state << 5;
+            uint16_t c = (uint16_t)(rand_state % combo_count);
+            bits_btn_mask_t chord = BITS_BTN_MASK_ZERO_INIT;
+            BITS_BTN_MASK_SET_BIT(chord, combo_keys[c][0]);
+            BITS_BTN_MASK_SET_BIT(chord, combo_keys[c][1]);
+            combo_bench_mask = chord;
+            chords++;
+        } else if (phase == 40) {
+            combo_bench_mask = zero_mask;
+        }
+        bits_button_ticks_ctx(&instance);
+    }
+    clock_t elapsed = clock() - start;
+
+    // 每次按下恰好命中一个组合键
+    TEST_ASSERT_EQUAL_UINT32(chords, combo_bench_pressed_events);
+    return (double)elapsed * 1e9 / CLOCKS_PER_SEC / COMBO_BENCH_TICKS;
+}
+
+void test_combo_matcher_scaling(void) {
+    printf("\n=== 测试组合键匹配扩展性 (最多 %d 个组合键) ===\n", (int)BITS_BTN_MAX_COMBO_BUTTONS);
+
+    const uint16_t combo_counts[] = {1, 8, 16, 32, 64, 128, 256};
+
+    for (size_t k = 0; k < ARRAY_SIZE(combo_counts) && combo_counts[k] <= BITS_BTN_MAX_COMBO_BUTTONS; k++) {
+        double ns_per_tick = bench_combo_matcher(combo_counts[k]);
+        printf("%3d 个组合键: %8.1f ns/tick\n", combo_counts[k], ns_per_tick);
+        TEST_ASSERT_TRUE(ns_per_tick >= 0);
+    }
+
+    printf("组合键匹配扩展性测试通过\n");
+}
@@ -0,0 +1,144 @@
+/* test_ring_benchmark.c - 结果环形缓冲区跨核SPSC吞吐基准 */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "unity.h"
+#include "core/test_framework.h"
+#include "config/test_config.h"
+#include "bits_button.h"
+
+#if defined(BITS_BTN_USE_C11_BUFFER) && (defined(__unix__) || defined(__APPLE__))
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define RING_BENCH_KEYS         8           // 一个tick最多产生的事件数，不超过缓冲区容量
+#define RING_BENCH_TICKS        200000UL
+#define RING_BENCH_TOGGLE       (BITS_BTN_DEBOUNCE_TICKS + 2)   // 每个电平保持的tick数，刚好越过消抖
+
+// 所有按键同时翻转，没有独立消抖时全局消抖也能让每次翻转生效
+#ifdef BITS_BTN_ENABLE_PER_KEY_DEBOUNCE
+#define RING_BENCH_DEBOUNCE     BITS_BTN_DEBOUNCE_PER_KEY
+#else
+#define RING_BENCH_DEBOUNCE     BITS_BTN_DEBOUNCE_GLOBAL
+#endif
+
+static bits_btn_mask_t ring_bench_mask;
+static bits_button_t ring_bench_instance;
+static size_t ring_bench_produced;
+static atomic_int ring_bench_done;
+static size_t ring_bench_consumed;
+
+static bits_btn_mask_t ring_bench_read_mask(void) {
+    return ring_bench_mask;
+}
+
+// 所有事件都写入缓冲区，并在生产者线程中计数
+static uint8_t ring_bench_filter(bits_btn_result_t result) {
+    (void)result;
+    ring_bench_produced++;
+    return 1;
+}
+
+// 尽量把生产者和消费者放在不同的核上，单核环境下忽略失败
+static void ring_bench_pin(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+static void *ring_bench_consumer(void *arg) {
+    bits_btn_result_t result;
+    (void)arg;
+
+    ring_bench_pin(1);
+    for (;;) {
+        int done = atomic_load(&ring_bench_done);
+        while (bits_button_get_key_result_ctx(&ring_bench_instance, &result)) {
+            ring_bench_consumed++;
+        }
+        if (done) {
+            break;
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+static double ring_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void test_ring_buffer_spsc_benchmark(void) {
+#ifdef BITS_BTN_USE_POW2_BUFFER
+    const char *name = "2的幂环形缓冲区 (自由递增索引)";
+#else
+    const char *name = "取模环形缓冲区";
+#endif
+    printf("\n=== 结果环形缓冲区SPSC吞吐基准: %s, 容量 %d ===\n", name, (int)get_bits_btn_buffer_capacity());
+
+    static const bits_btn_obj_param_t param = TEST_DEFAULT_PARAM();
+    static button_obj_t btns[RING_BENCH_KEYS];
+    for (uint16_t i = 0; i < RING_BENCH_KEYS; i++) {
+        btns[i] = (button_obj_t)BITS_BUTTON_INIT(i, 1, &param);
+    }
+
+    bits_btn_config_t config = {
+        .btns = btns,
+        .btns_cnt = RING_BENCH_KEYS,
+        .read_button_mask_func = ring_bench_read_mask,
+        .debounce_mode = RING_BENCH_DEBOUNCE
+    };
+    bits_btn_register_result_filter_callback_ctx(&ring_bench_instance, ring_bench_filter);
+    TEST_ASSERT_EQUAL(BITS_BTN_OK, bits_button_init_ctx(&ring_bench_instance, &config));
+
+    bits_btn_mask_t all = BITS_BTN_MASK_ZERO_INIT;
+    for (uint16_t i = 0; i < RING_BENCH_KEYS; i++) {
+        BITS_BTN_MASK_SET_BIT(all, i);
+    }
+    bits_btn_mask_t none = BITS_BTN_MASK_ZERO_INIT;
+
+    ring_bench_produced = 0;
+    ring_bench_consumed = 0;
+    atomic_store(&ring_bench_done, 0);
+    size_t overwrite_before = get_bits_btn_buffer_overwrite_count_ctx(&ring_bench_instance);
+
+    pthread_t consumer;
+    TEST_ASSERT_EQUAL(0, pthread_create(&consumer, NULL, ring_bench_consumer, NULL));
+
+    ring_bench_pin(0);
+    double start = ring_bench_now();
+    for (unsigned long tick = 0; tick < RING_BENCH_TICKS; tick++) {
+        // 留出一个tick的空间再推进，测量交接吞吐而不是覆盖
+        while (get_bits_btn_buffer_capacity_ctx(&ring_bench_instance)
+               - get_bits_btn_buffer_used_count_ctx(&ring_bench_instance) < RING_BENCH_KEYS) {
+            sched_yield();
+        }
+        ring_bench_mask = ((tick / RING_BENCH_TOGGLE) & 1U) ? none : all;
+        bits_button_ticks_ctx(&ring_bench_instance);
+    }
+    atomic_store(&ring_bench_done, 1);
+    pthread_join(consumer, NULL);
+    double elapsed = ring_bench_now() - start;
+
+    size_t overwrites = get_bits_btn_buffer_overwrite_count_ctx(&ring_bench_instance) - overwrite_before;
+    printf("生产 %zu 个事件, 消费 %zu 个, 覆盖 %zu 个, 耗时 %.3f s, 吞吐 %.2f M事件/s\n",
+           ring_bench_produced, ring_bench_consumed, overwrites, elapsed,
+           elapsed > 0 ? ring_bench_consumed / elapsed / 1e6 : 0.0);
+
+    TEST_ASSERT_TRUE(ring_bench_produced > 0);
+    TEST_ASSERT_EQUAL_size_t(0, overwrites);
+    TEST_ASSERT_EQUAL_size_t(ring_bench_produced, ring_bench_consumed);
+}
+#else
+void test_ring_buffer_spsc_benchmark(void) {
+    TEST_IGNORE_MESSAGE("需要默认C11缓冲区与pthread");
+}
+#endif
@@ -31,6 +31,11 @@ extern void test_high_frequency_button_presses(void);
 extern void test_multiple_buttons_concurrent(void);
 extern void test_long_running_stability(void);
 extern void test_memory_usage(void);
+extern void test_combo_matcher_scaling(void);
+extern void test_debounce_strategy_benchmark(void);
+extern void test_dispatch_active_set_benchmark(void);
+extern void test_state_engine_benchmark(void);
+extern void test_ring_buffer_spsc_benchmark(void);
 
 // 新增测试函数
 // 缓冲区操作测试
@@ -40,6 +45,11 @@ extern void test_buffer_edge_cases(void);
 extern void test_buffer_overwrite_data_correctness(void);
 extern void test_buffer_overwrite_multiple_cycles(void);
 extern void test_buffer_overwrite_count_accuracy(void);
+extern void test_buffer_batch_read(void);
+extern void test_buffer_overflow_policy_drop_newest(void);
+extern void test_buffer_overflow_policy_coalesce(void);
+extern void test_buffer_overflow_policy_coalesce_terminal(void);
+extern void test_buffer_overflow_policy_coalesce_two_keys(void);
 
 // 高级组合按键测试
 extern void test_advanced_three_key_combo(void);
@@ -69,12 +79,94 @@ extern void test_different_active_levels(void);
 extern void test_custom_parameters(void);
 extern void test_multiple_button_initialization(void);
 extern void test_callback_functions(void);
+extern void test_read_mask_callback(void);
 
 // Peek功能测试
 extern void test_peek_functionality(void);
 extern void test_peek_vs_get_behavior(void);
 extern void test_peek_disabled_buffer_mode(void);
 
+// 多实例测试
+extern void test_multi_instance_independence(void);
+extern void test_multi_instance_filter(void);
+extern void test_multi_instance_buffer_storage(void);
+
+// 按键状态查询测试
+extern void test_key_state_query(void);
+extern void test_key_index_map_collisions(void);
+
+// 键值模式提前结束测试
+extern void test_pattern_early_finish(void);
+extern void test_pattern_finish_engines_agree(void);
+extern void test_pattern_sets_invalid(void);
+
+// 事件处理函数表测试
+#ifdef BITS_BTN_ENABLE_HANDLERS
+extern void test_result_handlers_dispatch(void);
+extern void test_result_handlers_full_table(void);
+#ifndef BITS_BTN_DISABLE_BUFFER
+extern void test_result_handlers_on_drain(void);
+#endif
+extern void test_result_handlers_invalid(void);
+#endif
+
+// 事件时间戳测试
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+extern void test_event_timestamps(void);
+#ifndef BITS_BTN_DISABLE_BUFFER
+extern void test_event_queue_age(void);
+#endif
+#endif
+
+// 事件管线统计测试
+#if defined(BITS_BTN_ENABLE_STATS) && !defined(BITS_BTN_DISABLE_BUFFER)
+extern void test_event_stats_histograms(void);
+extern void test_event_stats_reset(void);
+#ifdef BITS_BTN_USE_C11_BUFFER
+extern void test_event_stats_coalesce_held(void);
+#endif
+#endif
+
+// 阻塞等待测试
+#ifdef BITS_BTN_ENABLE_WAIT
+extern void test_wait_key_result_timeout(void);
+extern void test_wait_key_result_wakeup(void);
+#endif
+
+// 事件描述符测试
+#ifdef BITS_BTN_ENABLE_EVENTFD
+extern void test_event_fd_readiness(void);
+extern void test_event_fd_epoll_loop(void);
+#endif
+
+// ticks线程测试
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+extern void test_tick_thread_runs_and_catches_up(void);
+extern void test_tick_thread_options(void);
+#endif
+
+// 无节拍模式测试
+extern void test_next_deadline(void);
+extern void test_ticks_elapsed_matches_polling(void);
+extern void test_ticks_elapsed_catch_up(void);
+
+// 消抖策略测试
+extern void test_per_key_debounce_isolation(void);
+extern void test_per_key_debounce_filters_bounce(void);
+extern void test_vertical_debounce_matches_per_key(void);
+
+// 状态机引擎测试
+extern void test_table_engine_matches_switch(void);
+extern void test_bitslice_engine_matches_switch(void);
+extern void test_bitslice_engine_ticks_elapsed(void);
+extern void test_soa_engine_matches_switch(void);
+extern void test_wheel_engine_matches_switch(void);
+extern void test_wheel_engine_long_timeouts(void);
+
+// 宽掩码测试
+extern void test_wide_mask_high_index_button(void);
+extern void test_wide_mask_cross_word_combo(void);
+
 // ==================== 测试套件设置函数 ====================
 
 void basic_tests_setup(void) {
@@ -169,6 +261,11 @@ int main(void) {
     RUN_TEST(test_multiple_buttons_concurrent);
     RUN_TEST(test_long_running_stability);
     RUN_TEST(test_memory_usage);
+    RUN_TEST(test_combo_matcher_scaling);
+    RUN_TEST(test_debounce_strategy_benchmark);
+    RUN_TEST(test_dispatch_active_set_benchmark);
+    RUN_TEST(test_state_engine_benchmark);
+    RUN_TEST(test_ring_buffer_spsc_benchmark);
 
     printf("\n【缓冲区操作测试】\n");
     RUN_TEST(test_buffer_overflow_protection);
@@ -177,6 +274,11 @@ int main(void) {
     RUN_TEST(test_buffer_overwrite_data_correctness);
     RUN_TEST(test_buffer_overwrite_multiple_cycles);
     RUN_TEST(test_buffer_overwrite_count_accuracy);
+    RUN_TEST(test_buffer_batch_read);
+    RUN_TEST(test_buffer_overflow_policy_drop_newest);
+    RUN_TEST(test_buffer_overflow_policy_coalesce);
+    RUN_TEST(test_buffer_overflow_policy_coalesce_terminal);
+    RUN_TEST(test_buffer_overflow_policy_coalesce_two_keys);
 
     printf("\n【高级组合按键测试】\n");
     RUN_TEST(test_advanced_three_key_combo);
@@ -206,12 +308,94 @@ int main(void) {
     RUN_TEST(test_custom_parameters);
     RUN_TEST(test_multiple_button_initialization);
     RUN_TEST(test_callback_functions);
+    RUN_TEST(test_read_mask_callback);
 
     printf("\n【Peek功能测试】\n");
     RUN_TEST(test_peek_functionality);
     RUN_TEST(test_peek_vs_get_behavior);
     RUN_TEST(test_peek_disabled_buffer_mode);
 
+    printf("\n【多实例测试】\n");
+    RUN_TEST(test_multi_instance_independence);
+    RUN_TEST(test_multi_instance_filter);
+    RUN_TEST(test_multi_instance_buffer_storage);
+
+    printf("\n【按键状态查询测试】\n");
+    RUN_TEST(test_key_state_query);
+    RUN_TEST(test_key_index_map_collisions);
+
+    printf("\n【键值模式提前结束测试】\n");
+    RUN_TEST(test_pattern_early_finish);
+    RUN_TEST(test_pattern_finish_engines_agree);
+    RUN_TEST(test_pattern_sets_invalid);
+
+    printf("\n【事件处理函数表测试】\n");
+#ifdef BITS_BTN_ENABLE_HANDLERS
+    RUN_TEST(test_result_handlers_dispatch);
+    RUN_TEST(test_result_handlers_full_table);
+#ifndef BITS_BTN_DISABLE_BUFFER
+    RUN_TEST(test_result_handlers_on_drain);
+#endif
+    RUN_TEST(test_result_handlers_invalid);
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENT_TIMESTAMPS
+    printf("\n【事件时间戳测试】\n");
+    RUN_TEST(test_event_timestamps);
+#ifndef BITS_BTN_DISABLE_BUFFER
+    RUN_TEST(test_event_queue_age);
+#endif
+#endif
+
+#if defined(BITS_BTN_ENABLE_STATS) && !defined(BITS_BTN_DISABLE_BUFFER)
+    printf("\n【事件管线统计测试】\n");
+    RUN_TEST(test_event_stats_histograms);
+    RUN_TEST(test_event_stats_reset);
+#ifdef BITS_BTN_USE_C11_BUFFER
+    RUN_TEST(test_event_stats_coalesce_held);
+#endif
+#endif
+
+#ifdef BITS_BTN_ENABLE_WAIT
+    printf("\n【阻塞等待测试】\n");
+    RUN_TEST(test_wait_key_result_timeout);
+    RUN_TEST(test_wait_key_result_wakeup);
+#endif
+
+#ifdef BITS_BTN_ENABLE_EVENTFD
+    printf("\n【事件描述符测试】\n");
+    RUN_TEST(test_event_fd_readiness);
+    RUN_TEST(test_event_fd_epoll_loop);
+#endif
+
+#ifdef BITS_BTN_ENABLE_TICK_THREAD
+    printf("\n【ticks线程测试】\n");
+    RUN_TEST(test_tick_thread_runs_and_catches_up);
+    RUN_TEST(test_tick_thread_options);
+#endif
+
+    printf("\n【无节拍模式测试】\n");
+    RUN_TEST(test_next_deadline);
+    RUN_TEST(test_ticks_elapsed_matches_polling);
+    RUN_TEST(test_ticks_elapsed_catch_up);
+
+    printf("\n【消抖策略测试】\n");
+    RUN_TEST(test_per_key_debounce_isolation);
+    RUN_TEST(test_per_key_debounce_filters_bounce);
+    RUN_TEST(test_vertical_debounce_matches_per_key);
+
+    printf("\n【状态机引擎测试】\n");
+    RUN_TEST(test_table_engine_matches_switch);
+    RUN_TEST(test_bitslice_engine_matches_switch);
+    RUN_TEST(test_bitslice_engine_ticks_elapsed);
+    RUN_TEST(test_soa_engine_matches_switch);
+    RUN_TEST(test_wheel_engine_matches_switch);
+    RUN_TEST(test_wheel_engine_long_timeouts);
+
+    printf("\n【宽掩码测试】\n");
+    RUN_TEST(test_wide_mask_high_index_button);
+    RUN_TEST(test_wide_mask_cross_word_combo);
+
     printf("\n========================================\n");
     printf("           测试完成\n");
     printf("========================================\n");